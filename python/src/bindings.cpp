@@ -17,10 +17,13 @@ PYBIND11_MODULE(ipctk, m)
     // broad_phase
     define_aabb(m);
     define_broad_phase(m);
+    define_auto_broad_phase(m);
     define_brute_force(m);
     define_bvh(m);
     define_hash_grid(m);
+    define_lbvh(m);
     define_spatial_hash(m);
+    define_static_dynamic_split(m);
     define_sweep_and_prune(m);
     define_sweep_and_tiniest_queue(m);
     define_voxel_size_heuristic(m);
@@ -91,6 +94,7 @@ PYBIND11_MODULE(ipctk, m)
 
     // utils
     define_area_gradient(m);
+    define_collision_groups(m);
     define_eigen_ext(m);
     define_interval(m);
     define_intersection(m);
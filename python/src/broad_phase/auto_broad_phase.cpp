@@ -0,0 +1,80 @@
+#include <common.hpp>
+
+#include <ipc/broad_phase/auto_broad_phase.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_auto_broad_phase(py::module_& m)
+{
+    py::class_<BroadPhaseStatistics>(
+        m, "BroadPhaseStatistics",
+        "Statistics of a mesh and its motion used to select a broad phase method.")
+        .def(py::init())
+        .def_static(
+            "compute", &BroadPhaseStatistics::compute,
+            R"ipc_Qu8mg5v7(
+            Compute the statistics of a mesh and its motion.
+
+            Parameters:
+                vertices_t0: Starting vertices of the vertices.
+                vertices_t1: Ending vertices of the vertices.
+                edges: Collision mesh edges
+                faces: Collision mesh faces
+
+            Returns:
+                The statistics.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
+            py::arg("faces"))
+        .def_readwrite(
+            "num_vertices", &BroadPhaseStatistics::num_vertices,
+            "Number of vertices.")
+        .def_readwrite(
+            "num_edges", &BroadPhaseStatistics::num_edges, "Number of edges.")
+        .def_readwrite(
+            "num_faces", &BroadPhaseStatistics::num_faces, "Number of faces.")
+        .def_readwrite(
+            "mean_edge_length", &BroadPhaseStatistics::mean_edge_length,
+            "Average edge length (over both time steps).")
+        .def_readwrite(
+            "edge_length_std_deviation",
+            &BroadPhaseStatistics::edge_length_std_deviation,
+            "Standard deviation of the edge lengths.")
+        .def_readwrite(
+            "max_edge_length", &BroadPhaseStatistics::max_edge_length,
+            "Maximum edge length.")
+        .def_readwrite(
+            "mean_displacement_length",
+            &BroadPhaseStatistics::mean_displacement_length,
+            "Average displacement length.")
+        .def_readwrite(
+            "displacement_length_std_deviation",
+            &BroadPhaseStatistics::displacement_length_std_deviation,
+            "Standard deviation of the displacement lengths.")
+        .def_readwrite(
+            "max_displacement_length",
+            &BroadPhaseStatistics::max_displacement_length,
+            "Maximum displacement length.");
+
+    py::class_<AutoBroadPhase, BroadPhase>(m, "AutoBroadPhase")
+        .def(py::init())
+        .def_static(
+            "select_method", &AutoBroadPhase::select_method,
+            R"ipc_Qu8mg5v7(
+            Select a broad phase method from the mesh and motion statistics.
+
+            Parameters:
+                statistics: The mesh and motion statistics.
+
+            Returns:
+                The selected method (never AUTO).
+            )ipc_Qu8mg5v7",
+            py::arg("statistics"))
+        .def_property_readonly(
+            "selected_method", &AutoBroadPhase::selected_method,
+            "The method currently selected (AUTO if not built).")
+        .def_readwrite(
+            "calibrate", &AutoBroadPhase::calibrate,
+            "Time the candidate methods on the first build of each new selection.");
+}
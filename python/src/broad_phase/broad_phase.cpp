@@ -17,15 +17,52 @@ void define_broad_phase(py::module_& m)
         .value(
             "BOUNDING_VOLUME_HIERARCHY", BroadPhaseMethod::BVH,
             "Bounding volume hierarchy")
+        .value(
+            "LINEAR_BOUNDING_VOLUME_HIERARCHY", BroadPhaseMethod::LBVH,
+            "Linear bounding volume hierarchy")
         .value(
             "SWEEP_AND_PRUNE", BroadPhaseMethod::SWEEP_AND_PRUNE,
             "Sweep and prune")
+        .value(
+            "AUTO", BroadPhaseMethod::AUTO,
+            "Automatic selection from the mesh and motion statistics")
         .value(
             "SWEEP_AND_TINIEST_QUEUE",
             BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE,
             "Sweep and tiniest queue (GPU)")
         .export_values();
 
+    py::class_<BroadPhaseProfile, std::shared_ptr<BroadPhaseProfile>>(
+        m, "BroadPhaseProfile", "Counters and timings of a broad phase pass.")
+        .def(py::init())
+        .def_readwrite(
+            "num_boxes", &BroadPhaseProfile::num_boxes,
+            "Number of boxes built (BroadPhase.build).")
+        .def_readwrite(
+            "memory_usage", &BroadPhaseProfile::memory_usage,
+            "Number of bytes allocated for the boxes (BroadPhase.build).")
+        .def_readwrite(
+            "box_build_time", &BroadPhaseProfile::box_build_time,
+            "Time in seconds to build the boxes (BroadPhase.build).")
+        .def_readwrite(
+            "build_time", &BroadPhaseProfile::build_time,
+            "Time in seconds of the complete build, including any acceleration structure (Candidates.build).")
+        .def_readwrite(
+            "num_candidates", &BroadPhaseProfile::num_candidates,
+            "Number of candidates emitted (BroadPhase.detect_collision_candidates and Candidates.build).")
+        .def_readwrite(
+            "detect_time", &BroadPhaseProfile::detect_time,
+            "Time in seconds to find the candidates (BroadPhase.detect_collision_candidates).")
+        .def_readwrite(
+            "num_true_positives", &BroadPhaseProfile::num_true_positives,
+            "Number of candidates that passed the distance filter (Collisions.build) or CCD (Candidates.compute_collision_free_stepsize).")
+        .def(
+            "false_positive_ratio", &BroadPhaseProfile::false_positive_ratio,
+            "Fraction of the candidates that did not pass the narrow phase filter.")
+        .def(
+            "reset", &BroadPhaseProfile::reset,
+            "Reset all counters and timings to zero.");
+
     py::class_<BroadPhase>(m, "BroadPhase")
         .def_static(
             "make_broad_phase", &BroadPhase::make_broad_phase,
@@ -156,5 +193,14 @@ void define_broad_phase(py::module_& m)
             py::arg("dim"))
         .def_readwrite(
             "can_vertices_collide", &BroadPhase::can_vertices_collide,
-            "Function for determining if two vertices can collide.");
+            "Function for determining if two vertices can collide.")
+        .def_readwrite(
+            "collision_groups", &BroadPhase::collision_groups,
+            "Built-in collision groups of the vertices.")
+        .def_readwrite(
+            "is_vertex_static", &BroadPhase::is_vertex_static,
+            "Flags marking the static vertices. By default (empty) no vertex is static.")
+        .def_readwrite(
+            "profile", &BroadPhase::profile,
+            "Profile filled in by build and detect_collision_candidates (None to disable profiling).");
 }
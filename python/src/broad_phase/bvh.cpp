@@ -7,5 +7,22 @@ using namespace ipc;
 
 void define_bvh(py::module_& m)
 {
-    py::class_<BVH, BroadPhase>(m, "BVH").def(py::init());
+    py::class_<BVH, BroadPhase>(m, "BVH")
+        .def(py::init())
+        .def(
+            py::init<bool, double>(),
+            R"ipc_Qu8mg5v7(
+            Construct a BVH broad phase.
+
+            Parameters:
+                enable_refit: Keep the tree topology between builds and only refit the node bounds.
+                rebuild_threshold: Rebuild the tree when its summed node surface area exceeds this multiple of the area at the last full build.
+            )ipc_Qu8mg5v7",
+            py::arg("enable_refit"), py::arg("rebuild_threshold") = 2.0)
+        .def_readwrite(
+            "enable_refit", &BVH::enable_refit,
+            "Keep the tree topology between builds and only refit the node bounds.")
+        .def_readwrite(
+            "rebuild_threshold", &BVH::rebuild_threshold,
+            "Rebuild a refitted tree when its summed node surface area exceeds this multiple of the area at the last full build.");
 }
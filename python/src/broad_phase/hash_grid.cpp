@@ -20,6 +20,59 @@ void define_hash_grid(py::module_& m)
 
     py::class_<HashGrid, BroadPhase>(m, "HashGrid")
         .def(py::init())
+        .def(
+            py::init<bool>(),
+            R"ipc_Qu8mg5v7(
+            Construct a hash grid.
+
+            Parameters:
+                use_radix_sort: Sort the hash items and candidate pairs with a parallel radix sort instead of a comparison sort.
+            )ipc_Qu8mg5v7",
+            py::arg("use_radix_sort"))
+        .def_readwrite(
+            "use_radix_sort", &HashGrid::use_radix_sort,
+            "Sort the hash items and candidate pairs with a parallel radix sort.")
+        .def_readwrite(
+            "enable_update", &HashGrid::enable_update,
+            "Make build update the grid (see update) when possible.")
+        .def(
+            "update",
+            py::overload_cast<
+                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, double>(&HashGrid::update),
+            R"ipc_Qu8mg5v7(
+            Update the hash grid for new positions of the same mesh.
+
+            The cell size and domain of the last build are reused and only the primitives whose range of cells changed are re-inserted. Falls back to a full build if the mesh changed or moved more than a cell outside of the domain of the grid.
+
+            Parameters:
+                vertices: Vertex positions
+                edges: Collision mesh edges
+                faces: Collision mesh faces
+                inflation_radius: Radius of inflation around all elements.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices"), py::arg("edges"), py::arg("faces"),
+            py::arg("inflation_radius") = 0)
+        .def(
+            "update",
+            py::overload_cast<
+                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
+                &HashGrid::update),
+            R"ipc_Qu8mg5v7(
+            Update the hash grid for new trajectories of the same mesh.
+
+            The cell size and domain of the last build are reused and only the primitives whose range of cells changed are re-inserted. Falls back to a full build if the mesh changed or moved more than a cell outside of the domain of the grid.
+
+            Parameters:
+                vertices_t0: Starting vertices of the vertices.
+                vertices_t1: Ending vertices of the vertices.
+                edges: Collision mesh edges
+                faces: Collision mesh faces
+                inflation_radius: Radius of inflation around all elements.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
+            py::arg("faces"), py::arg("inflation_radius") = 0)
         .def_property_readonly("cell_size", &HashGrid::cell_size)
         .def_property_readonly(
             "grid_size", &HashGrid::grid_size,
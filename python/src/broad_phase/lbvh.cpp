@@ -0,0 +1,11 @@
+#include <common.hpp>
+
+#include <ipc/broad_phase/lbvh.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_lbvh(py::module_& m)
+{
+    py::class_<LBVH, BroadPhase>(m, "LBVH").def(py::init());
+}
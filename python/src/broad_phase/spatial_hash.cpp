@@ -62,8 +62,19 @@ void define_spatial_hash(py::module_& m)
         .def_readwrite("voxel_count_0x1", &SpatialHash::voxel_count_0x1)
         .def_readwrite("edge_start_ind", &SpatialHash::edge_start_ind)
         .def_readwrite("tri_start_ind", &SpatialHash::tri_start_ind)
-        .def_readwrite("voxel", &SpatialHash::voxel_to_primitives)
-        .def_readwrite("point_to_voxels", &SpatialHash::point_to_voxels)
-        .def_readwrite("edge_to_voxels", &SpatialHash::edge_to_voxels)
-        .def_readwrite("face_to_voxels", &SpatialHash::face_to_voxels);
+        .def_readonly(
+            "occupied_voxels", &SpatialHash::occupied_voxels,
+            "Sorted indices of the voxels containing at least one primitive.")
+        .def_readonly(
+            "voxel_primitive_offsets", &SpatialHash::voxel_primitive_offsets,
+            "Offsets of each occupied voxel's primitives in voxel_primitives.")
+        .def_readonly(
+            "voxel_primitives", &SpatialHash::voxel_primitives,
+            "Primitive indices contained in each occupied voxel (sorted).")
+        .def_readonly(
+            "primitive_voxel_offsets", &SpatialHash::primitive_voxel_offsets,
+            "Offsets of each primitive's voxels in primitive_voxels.")
+        .def_readonly(
+            "primitive_voxels", &SpatialHash::primitive_voxels,
+            "Positions in occupied_voxels of the voxels of each primitive.");
 }
@@ -0,0 +1,29 @@
+#include <common.hpp>
+
+#include <ipc/broad_phase/static_dynamic_split.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_static_dynamic_split(py::module_& m)
+{
+    py::class_<StaticDynamicSplit, BroadPhase>(m, "StaticDynamicSplit")
+        .def(
+            py::init([](const BroadPhaseMethod method) {
+                return std::make_unique<StaticDynamicSplit>(
+                    BroadPhase::make_broad_phase(method));
+            }),
+            R"ipc_Qu8mg5v7(
+            Construct a static/dynamic split broad phase.
+
+            Parameters:
+                method: Broad phase method used for the dynamic primitives.
+            )ipc_Qu8mg5v7",
+            py::arg("method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def_property_readonly(
+            "is_static_built", &StaticDynamicSplit::is_static_built,
+            "Are the static BVHs built (and reused by the next build)?")
+        .def_property_readonly(
+            "was_static_rebuilt", &StaticDynamicSplit::was_static_rebuilt,
+            "Were the static BVHs rebuilt (rather than reused) by the last build?");
+}
@@ -5,7 +5,63 @@
 namespace py = pybind11;
 using namespace ipc;
 
+namespace {
+template <typename Candidate>
+std::pair<std::vector<Candidate>, std::vector<Candidate>>
+to_pair(const CandidatesDelta<Candidate>& delta)
+{
+    return std::make_pair(delta.added, delta.removed);
+}
+} // namespace
+
 void define_sweep_and_prune(py::module_& m)
 {
     py::class_<SweepAndPrune, BroadPhase>(m, "SweepAndPrune").def(py::init());
+
+    py::class_<CoherentSweepAndPrune, SweepAndPrune>(
+        m, "CoherentSweepAndPrune")
+        .def(py::init())
+        .def_property_readonly(
+            "vertex_vertex_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.vertex_vertex_delta());
+            },
+            "Vertex-vertex candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "edge_vertex_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.edge_vertex_delta());
+            },
+            "Edge-vertex candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "edge_edge_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.edge_edge_delta());
+            },
+            "Edge-edge candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "face_vertex_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.face_vertex_delta());
+            },
+            "Face-vertex candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "edge_face_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.edge_face_delta());
+            },
+            "Edge-face candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "face_face_delta",
+            [](const CoherentSweepAndPrune& self) {
+                return to_pair(self.face_face_delta());
+            },
+            "Face-face candidates (added, removed) by the last build.")
+        .def_property_readonly(
+            "was_incremental", &CoherentSweepAndPrune::was_incremental,
+            "Whether the last build updated the previous one incrementally.")
+        .def_readwrite(
+            "max_swaps_per_endpoint",
+            &CoherentSweepAndPrune::max_swaps_per_endpoint,
+            "Maximum number of endpoint swaps per endpoint before falling back to a full build.");
 }
@@ -48,6 +48,55 @@ void define_candidates(py::module_& m)
             py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
             py::arg("inflation_radius") = 0,
             py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD)
+        .def(
+            "build",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                BroadPhase&>(&Candidates::build),
+            R"ipc_Qu8mg5v7(
+            Initialize the set of discrete collision detection candidates using a persistent broad phase.
+
+            The broad phase is owned by the caller, so broad phases that reuse
+            data between builds (e.g., a refitted BVH) do so across calls. Its
+            filters and static vertices are set from the mesh. The codim.
+            vertex-vertex candidates are found with a separate broad phase of
+            the default method, so the given one keeps its data.
+
+            Parameters:
+                mesh: The surface of the collision mesh.
+                vertices: Surface vertex positions (rowwise).
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase: Broad phase to (re)build over the vertices.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices"), py::arg("inflation_radius"),
+            py::arg("broad_phase"))
+        .def(
+            "build",
+            py::overload_cast<
+                const CollisionMesh&, const Eigen::MatrixXd&,
+                const Eigen::MatrixXd&, const double, BroadPhase&>(
+                &Candidates::build),
+            R"ipc_Qu8mg5v7(
+            Initialize the set of continuous collision detection candidates using a persistent broad phase.
+
+            The broad phase is owned by the caller, so broad phases that reuse
+            data between builds (e.g., a refitted BVH) do so across calls. Its
+            filters and static vertices are set from the mesh. The codim.
+            vertex-vertex candidates are found with a separate broad phase of
+            the default method, so the given one keeps its data.
+
+            Note:
+                Assumes the trajectory is linear.
+
+            Parameters:
+                mesh: The surface of the collision mesh.
+                vertices_t0: Surface vertex starting positions (rowwise).
+                vertices_t1: Surface vertex ending positions (rowwise).
+                inflation_radius: Amount to inflate the bounding boxes.
+                broad_phase: Broad phase to (re)build over the vertices.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("inflation_radius"), py::arg("broad_phase"))
         .def("__len__", &Candidates::size)
         .def("empty", &Candidates::empty)
         .def("clear", &Candidates::clear)
@@ -142,5 +191,8 @@ void define_candidates(py::module_& m)
         .def_readwrite("vv_candidates", &Candidates::vv_candidates)
         .def_readwrite("ev_candidates", &Candidates::ev_candidates)
         .def_readwrite("ee_candidates", &Candidates::ee_candidates)
-        .def_readwrite("fv_candidates", &Candidates::fv_candidates);
+        .def_readwrite("fv_candidates", &Candidates::fv_candidates)
+        .def_readwrite(
+            "broad_phase_profile", &Candidates::broad_phase_profile,
+            "Profile of the broad phase filled in by build and compute_collision_free_stepsize (None to disable profiling).");
 }
@@ -61,5 +61,22 @@ void define_continuous_collision_candidate(py::module_& m)
                 vertices_t0: Stencil vertices at the start of the time step.
                 vertices_t1: Stencil vertices at the end of the time step.
             )ipc_Qu8mg5v7",
-            py::arg("vertices_t0"), py::arg("vertices_t1"));
+            py::arg("vertices_t0"), py::arg("vertices_t1"))
+        .def(
+            "toi_lower_bound", &ContinuousCollisionCandidate::toi_lower_bound,
+            R"ipc_Qu8mg5v7(
+            Compute a conservative lower bound on the time of impact.
+
+            The distance between the primitives decreases at most by the maximum relative displacement of their points, so the bound is the initial distance (minus min_distance) divided by that displacement.
+
+            Parameters:
+                vertices_t0: Stencil vertices at the start of the time step.
+                vertices_t1: Stencil vertices at the end of the time step.
+                min_distance: Minimum separation distance between primitives.
+
+            Returns:
+                Lower bound on the time of impact (normalized), infinity if the primitives cannot collide.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices_t0"), py::arg("vertices_t1"),
+            py::arg("min_distance") = 0.0);
 }
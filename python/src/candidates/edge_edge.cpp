@@ -10,7 +10,9 @@ void define_edge_edge_candidate(py::module_& m)
     py::class_<
         EdgeEdgeCandidate, CollisionStencil, ContinuousCollisionCandidate>(
         m, "EdgeEdgeCandidate")
-        .def(py::init<long, long>(), py::arg("edge0_id"), py::arg("edge1_id"))
+        .def(
+            py::init<index_t, index_t>(), py::arg("edge0_id"),
+            py::arg("edge1_id"))
         .def("known_dtype", &EdgeEdgeCandidate::known_dtype)
         .def(
             "__str__",
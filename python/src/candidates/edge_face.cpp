@@ -9,7 +9,9 @@ using namespace ipc;
 void define_edge_face_candidate(py::module_& m)
 {
     py::class_<EdgeFaceCandidate>(m, "EdgeFaceCandidate")
-        .def(py::init<long, long>(), py::arg("edge_id"), py::arg("face_id"))
+        .def(
+            py::init<index_t, index_t>(), py::arg("edge_id"),
+            py::arg("face_id"))
         .def(
             "__str__",
             [](const EdgeFaceCandidate& ev) {
@@ -10,7 +10,9 @@ void define_edge_vertex_candidate(py::module_& m)
     py::class_<
         EdgeVertexCandidate, CollisionStencil, ContinuousCollisionCandidate>(
         m, "EdgeVertexCandidate")
-        .def(py::init<long, long>(), py::arg("edge_id"), py::arg("vertex_id"))
+        .def(
+            py::init<index_t, index_t>(), py::arg("edge_id"),
+            py::arg("vertex_id"))
         .def("known_dtype", &EdgeVertexCandidate::known_dtype)
         .def(
             "__str__",
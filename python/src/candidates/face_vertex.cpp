@@ -10,7 +10,9 @@ void define_face_vertex_candidate(py::module_& m)
     py::class_<
         FaceVertexCandidate, CollisionStencil, ContinuousCollisionCandidate>(
         m, "FaceVertexCandidate")
-        .def(py::init<long, long>(), py::arg("face_id"), py::arg("vertex_id"))
+        .def(
+            py::init<index_t, index_t>(), py::arg("face_id"),
+            py::arg("vertex_id"))
         .def("known_dtype", &FaceVertexCandidate::known_dtype)
         .def(
             "__str__",
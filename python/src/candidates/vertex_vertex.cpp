@@ -11,7 +11,7 @@ void define_vertex_vertex_candidate(py::module_& m)
         VertexVertexCandidate, CollisionStencil, ContinuousCollisionCandidate>(
         m, "VertexVertexCandidate")
         .def(
-            py::init<long, long>(), py::arg("vertex0_id"),
+            py::init<index_t, index_t>(), py::arg("vertex0_id"),
             py::arg("vertex1_id"))
         .def(
             "__str__",
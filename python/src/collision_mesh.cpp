@@ -11,7 +11,8 @@ void define_collision_mesh(py::module_& m)
         .def(
             py::init<
                 const Eigen::MatrixXd&, const Eigen::MatrixXi&,
-                const Eigen::MatrixXi&, const Eigen::SparseMatrix<double>&>(),
+                const Eigen::MatrixXi&, const Eigen::SparseMatrix<double>&,
+                const bool>(),
             R"ipc_Qu8mg5v7(
             Construct a new Collision Mesh object directly from the collision mesh vertices.
 
@@ -20,14 +21,16 @@ void define_collision_mesh(py::module_& m)
                 edges: The edges of the collision mesh (#E × 2).
                 faces: The faces of the collision mesh (#F × 3).
                 displacement_map: The displacement mapping from displacements on the full mesh to the collision mesh.
+                reorder: Reorder the vertices, edges, and faces along a Morton curve for memory locality (see the other constructor).
             )ipc_Qu8mg5v7",
             py::arg("rest_positions"), py::arg("edges"), py::arg("faces"),
-            py::arg("displacement_map") = Eigen::SparseMatrix<double>())
+            py::arg("displacement_map") = Eigen::SparseMatrix<double>(),
+            py::arg("reorder") = false)
         .def(
             py::init<
                 const std::vector<bool>&, const Eigen::MatrixXd&,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&,
-                const Eigen::SparseMatrix<double>&>(),
+                const Eigen::SparseMatrix<double>&, const bool>(),
             R"ipc_Qu8mg5v7(
             Construct a new Collision Mesh object from a full mesh vertices.
 
@@ -37,10 +40,12 @@ void define_collision_mesh(py::module_& m)
                 edges: The edges of the collision mesh indexed into the full mesh vertices (#E × 2).
                 faces: The faces of the collision mesh indexed into the full mesh vertices (#F × 3).
                 displacement_map: The displacement mapping from displacements on the full mesh to the collision mesh.
+                reorder: Reorder the vertices, edges, and faces along a Morton curve of their rest positions for memory locality. The collision vertices are then a permutation of the included full vertices, so always compute them with vertices() or displace_vertices(). Use to_input_edge_id() and to_input_face_id() to map edges and faces back to the given rows. can_collide, collision_groups, and is_vertex_static are indexed by the permuted collision vertex IDs (see to_full_vertex_id()).
             )ipc_Qu8mg5v7",
             py::arg("include_vertex"), py::arg("full_rest_positions"),
             py::arg("edges"), py::arg("faces"),
-            py::arg("displacement_map") = Eigen::SparseMatrix<double>())
+            py::arg("displacement_map") = Eigen::SparseMatrix<double>(),
+            py::arg("reorder") = false)
         .def_static(
             "build_from_full_mesh", &CollisionMesh::build_from_full_mesh,
             R"ipc_Qu8mg5v7(
@@ -50,11 +55,13 @@ void define_collision_mesh(py::module_& m)
                 full_rest_positions: The full vertices at rest (#FV × dim).
                 edges: The edge matrix of mesh (#E × 2).
                 faces: The face matrix of mesh (#F × 3).
+                reorder: Reorder the vertices, edges, and faces along a Morton curve of their rest positions for memory locality (see the constructor).
 
             Returns:
                 Constructed CollisionMesh.
             )ipc_Qu8mg5v7",
-            py::arg("full_rest_positions"), py::arg("edges"), py::arg("faces"))
+            py::arg("full_rest_positions"), py::arg("edges"), py::arg("faces"),
+            py::arg("reorder") = false)
         .def(
             "init_adjacencies", &CollisionMesh::init_adjacencies,
             "Initialize vertex-vertex and edge-vertex adjacencies.")
@@ -153,6 +160,30 @@ void define_collision_mesh(py::module_& m)
                 Vertex ID in the full mesh.
             )ipc_Qu8mg5v7",
             py::arg("id"))
+        .def(
+            "to_input_edge_id", &CollisionMesh::to_input_edge_id,
+            R"ipc_Qu8mg5v7(
+            Map an edge ID to the row of the edges given at construction.
+
+            Parameters:
+                id: Edge ID in the collision mesh.
+
+            Returns:
+                Row of the edge in the edges given at construction.
+            )ipc_Qu8mg5v7",
+            py::arg("id"))
+        .def(
+            "to_input_face_id", &CollisionMesh::to_input_face_id,
+            R"ipc_Qu8mg5v7(
+            Map a face ID to the row of the faces given at construction.
+
+            Parameters:
+                id: Face ID in the collision mesh.
+
+            Returns:
+                Row of the face in the faces given at construction.
+            )ipc_Qu8mg5v7",
+            py::arg("id"))
         .def(
             "to_full_dof",
             py::overload_cast<const Eigen::VectorXd&>(
@@ -312,5 +343,19 @@ void define_collision_mesh(py::module_& m)
             A function that takes two vertex IDs and returns true if the vertices (and faces or edges containing the vertices) can collide.
 
             By default all primitives can collide with all other primitives.
+            )ipc_Qu8mg5v7")
+        .def_readwrite(
+            "collision_groups", &CollisionMesh::collision_groups,
+            R"ipc_Qu8mg5v7(
+            Built-in collision groups of the vertices.
+
+            Two vertices can collide only if both collision_groups and can_collide allow it. Prefer this over can_collide because the broad phase can inline it. By default there are no groups.
+            )ipc_Qu8mg5v7")
+        .def_readwrite(
+            "is_vertex_static", &CollisionMesh::is_vertex_static,
+            R"ipc_Qu8mg5v7(
+            Flags marking the static vertices (i.e., vertices that never move).
+
+            A primitive is static if all of its vertices are static. Static primitives are never checked against each other by a StaticDynamicSplit broad phase. By default (empty) no vertex is static.
             )ipc_Qu8mg5v7");
 }
@@ -154,5 +154,8 @@ void define_collisions(py::module_& m)
         .def_readwrite("ev_collisions", &Collisions::ev_collisions)
         .def_readwrite("ee_collisions", &Collisions::ee_collisions)
         .def_readwrite("fv_collisions", &Collisions::fv_collisions)
-        .def_readwrite("pv_collisions", &Collisions::pv_collisions);
+        .def_readwrite("pv_collisions", &Collisions::pv_collisions)
+        .def_readwrite(
+            "broad_phase_profile", &Collisions::broad_phase_profile,
+            "Profile of the broad phase filled in by build (None to disable profiling).");
 }
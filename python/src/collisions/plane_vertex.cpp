@@ -9,7 +9,7 @@ void define_plane_vertex_collision(py::module_& m)
 {
     py::class_<PlaneVertexCollision, Collision>(m, "PlaneVertexCollision")
         .def(
-            py::init<const VectorMax3d&, const VectorMax3d&, const long>(),
+            py::init<const VectorMax3d&, const VectorMax3d&, const index_t>(),
             py::arg("plane_origin"), py::arg("plane_normal"),
             py::arg("vertex_id"))
         .def_readwrite("plane_origin", &PlaneVertexCollision::plane_origin)
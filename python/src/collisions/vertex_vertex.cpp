@@ -10,12 +10,12 @@ void define_vertex_vertex_collision(py::module_& m)
     py::class_<VertexVertexCollision, VertexVertexCandidate, Collision>(
         m, "VertexVertexCollision")
         .def(
-            py::init<long, long>(), "", py::arg("vertex0_id"),
+            py::init<index_t, index_t>(), "", py::arg("vertex0_id"),
             py::arg("vertex1_id"))
         .def(py::init<const VertexVertexCandidate&>(), py::arg("vv_candidate"));
     // .def(
     //     py::init<
-    //         const long, const long, const double,
+    //         const index_t, const index_t, const double,
     //         const Eigen::SparseVector<double>&>(),
     //     py::arg("vertex0_id"), py::arg("vertex1_id"), py::arg("weight"),
     //     py::arg("weight_gradient"));
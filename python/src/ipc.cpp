@@ -12,7 +12,11 @@ void define_ipc(py::module_& m)
     m.attr("__version__") = IPC_TOOLKIT_VER;
 
     m.def(
-        "is_step_collision_free", &is_step_collision_free,
+        "is_step_collision_free",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const Eigen::MatrixXd&, const BroadPhaseMethod, const double,
+            const double, const long>(&is_step_collision_free),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free.
 
@@ -38,7 +42,43 @@ void define_ipc(py::module_& m)
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
 
     m.def(
-        "compute_collision_free_stepsize", &compute_collision_free_stepsize,
+        "is_step_collision_free",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const Eigen::MatrixXd&, BroadPhase&, const double, const double,
+            const long>(&is_step_collision_free),
+        R"ipc_Qu8mg5v7(
+        Determine if the step is collision free using a persistent broad phase.
+
+        The broad phase is owned by the caller, so broad phases that reuse data
+        between builds (e.g., a refitted BVH) do so across calls.
+
+        Note:
+            Assumes the trajectory is linear.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices_t0: Surface vertex vertices at start as rows of a matrix.
+            vertices_t1: Surface vertex vertices at end as rows of a matrix.
+            broad_phase: Broad phase to (re)build over the vertices.
+            min_distance: The minimum distance allowable between any two elements.
+            tolerance: The tolerance for the CCD algorithm.
+            max_iterations: The maximum number of iterations for the CCD algorithm.
+
+        Returns:
+            True if <b>any</b> collisions occur.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+        py::arg("broad_phase"), py::arg("min_distance") = 0.0,
+        py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
+
+    m.def(
+        "compute_collision_free_stepsize",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const Eigen::MatrixXd&, const BroadPhaseMethod, const double,
+            const double, const long>(&compute_collision_free_stepsize),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
@@ -64,7 +104,42 @@ void define_ipc(py::module_& m)
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
 
     m.def(
-        "has_intersections", &has_intersections,
+        "compute_collision_free_stepsize",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const Eigen::MatrixXd&, BroadPhase&, const double, const double,
+            const long>(&compute_collision_free_stepsize),
+        R"ipc_Qu8mg5v7(
+        Computes a maximal step size that is collision free using a persistent broad phase.
+
+        The broad phase is owned by the caller, so broad phases that reuse data
+        between builds (e.g., a refitted BVH) do so across calls.
+
+        Note:
+            Assumes the trajectory is linear.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices_t0: Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+            vertices_t1: Surface vertex vertices at end as rows of a matrix.
+            broad_phase: Broad phase to (re)build over the vertices.
+            min_distance: The minimum distance allowable between any two elements.
+            tolerance: The tolerance for the CCD algorithm.
+            max_iterations: The maximum number of iterations for the CCD algorithm.
+
+        Returns:
+            A step-size :math:`\in [0, 1]` that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("vertices_t0"), py::arg("vertices_t1"),
+        py::arg("broad_phase"), py::arg("min_distance") = 0.0,
+        py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
+
+    m.def(
+        "has_intersections",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const BroadPhaseMethod>(&has_intersections),
         R"ipc_Qu8mg5v7(
         Determine if the mesh has self intersections.
 
@@ -79,6 +154,36 @@ void define_ipc(py::module_& m)
         py::arg("mesh"), py::arg("vertices"),
         py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD);
 
+    m.def(
+        "has_intersections",
+        py::overload_cast<
+            const CollisionMesh&, const Eigen::MatrixXd&,
+            const Eigen::MatrixXd&, const double, BroadPhase&>(
+            &has_intersections),
+        R"ipc_Qu8mg5v7(
+        Determine if the mesh has self intersections involving primitives that moved since an intersection-free state.
+
+        Only pairs of primitives where at least one vertex moved more than the
+        displacement tolerance are tested, so the narrow phase only runs on the
+        moving part of the mesh. The broad phase is rebuilt every call, so reuse
+        the same broad phase across calls; when the topology does not change, a
+        BVH with enable_refit or a HashGrid with enable_update avoids rebuilding
+        it from scratch. Its can_vertices_collide and collision_groups are
+        restored before returning.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices_verified: Vertices of the last state known to be intersection-free.
+            vertices: Vertices of the collision mesh to check.
+            displacement_tolerance: Vertices that moved at most this distance are considered at rest.
+            broad_phase: Persistent broad phase to (re)build over the vertices.
+
+        Returns:
+            A boolean for if the mesh has intersections.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("vertices_verified"), py::arg("vertices"),
+        py::arg("displacement_tolerance"), py::arg("broad_phase"));
+
     m.def(
         "edges",
         [](const Eigen::MatrixXi& F) {
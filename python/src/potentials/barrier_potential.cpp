@@ -142,7 +142,7 @@ void define_barrier_potential(py::module_& m)
         .def(
             "shape_derivative",
             [](const DistanceBasedPotential& self, const Collision& collision,
-               const std::array<long, 4>& vertex_ids,
+               const std::array<index_t, 4>& vertex_ids,
                const VectorMax12d& rest_positions,
                const VectorMax12d& positions) {
                 std::vector<Eigen::Triplet<double>> out;
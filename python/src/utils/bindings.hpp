@@ -4,6 +4,7 @@
 namespace py = pybind11;
 
 void define_area_gradient(py::module_& m);
+void define_collision_groups(py::module_& m);
 void define_eigen_ext(py::module_& m);
 void define_interval(py::module_& m);
 void define_intersection(py::module_& m);
@@ -0,0 +1,61 @@
+#include <common.hpp>
+
+#include <ipc/utils/collision_groups.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_collision_groups(py::module_& m)
+{
+    py::class_<CollisionGroups>(m, "CollisionGroups")
+        .def(
+            py::init(),
+            "Construct empty collision groups (all vertices can collide).")
+        .def(
+            py::init<const Eigen::VectorXi&, const std::vector<uint64_t>&>(),
+            R"ipc_Qu8mg5v7(
+            Construct collision groups from per-vertex group ids and per-group masks.
+
+            Parameters:
+                vertex_groups: Group id of each vertex (#V × 1).
+                group_masks: Bit j of group_masks[i] is set if groups i and j can collide. The masks must be symmetric.
+            )ipc_Qu8mg5v7",
+            py::arg("vertex_groups"), py::arg("group_masks"))
+        .def_static(
+            "inter_group_only", &CollisionGroups::inter_group_only,
+            R"ipc_Qu8mg5v7(
+            Construct collision groups where only vertices of different groups can collide.
+
+            Parameters:
+                vertex_groups: Group id of each vertex (#V × 1).
+
+            Returns:
+                Constructed collision groups.
+            )ipc_Qu8mg5v7",
+            py::arg("vertex_groups"))
+        .def(
+            "__call__", &CollisionGroups::operator(),
+            R"ipc_Qu8mg5v7(
+            Determine if two vertices can collide.
+
+            Parameters:
+                vi: ID of the first vertex.
+                vj: ID of the second vertex.
+
+            Returns:
+                True if the groups of the vertices can collide.
+            )ipc_Qu8mg5v7",
+            py::arg("vi"), py::arg("vj"))
+        .def(
+            "empty", &CollisionGroups::empty,
+            "Are there no collision groups (i.e., all vertices can collide)?")
+        .def_property_readonly(
+            "vertex_groups", &CollisionGroups::vertex_groups,
+            "Group id of each vertex (#V × 1).")
+        .def_property_readonly(
+            "group_masks", &CollisionGroups::group_masks,
+            "Collision mask of each group.")
+        .def_readonly_static(
+            "MAX_GROUPS", &CollisionGroups::MAX_GROUPS,
+            "Maximum number of groups (one bit per group in a mask).");
+}
@@ -18,6 +18,7 @@ def broad_phase_methods():
     yield ipctk.BroadPhaseMethod.HASH_GRID
     yield ipctk.BroadPhaseMethod.SPATIAL_HASH
     yield ipctk.BroadPhaseMethod.BOUNDING_VOLUME_HIERARCHY
+    yield ipctk.BroadPhaseMethod.LINEAR_BOUNDING_VOLUME_HIERARCHY
     yield ipctk.BroadPhaseMethod.SWEEP_AND_PRUNE
 
 
@@ -1,9 +1,22 @@
 #include "aabb.hpp"
 
+#include <ipc/config.hpp>
+
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
+#if defined(IPC_TOOLKIT_WITH_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define IPC_TOOLKIT_AABB_AVX2
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+#define IPC_TOOLKIT_AABB_AVX512
+#endif
+#endif
+
+#include <algorithm>
 #include <cfenv>
+#include <cmath>
+#include <limits>
 
 namespace ipc {
 
@@ -58,6 +71,221 @@ void AABB::conservative_inflation(
     std::fesetround(current_round);
 }
 
+// ============================================================================
+
+void CompactAABBs::resize(const size_t size, const int dim)
+{
+    assert(size == 0 || dim == 2 || dim == 3);
+    m_dim = dim;
+    for (int d = 0; d < 3; d++) {
+        min[d].resize(d < dim ? size : 0);
+        max[d].resize(d < dim ? size : 0);
+    }
+    vertex_ids.resize(size);
+}
+
+void CompactAABBs::clear()
+{
+    for (int d = 0; d < 3; d++) {
+        min[d].clear();
+        max[d].clear();
+    }
+    vertex_ids.clear();
+    m_dim = 0;
+}
+
+size_t CompactAABBs::memory_usage() const
+{
+    size_t bytes = vertex_ids.capacity() * sizeof(std::array<int, 3>);
+    for (int d = 0; d < 3; d++) {
+        bytes += (min[d].capacity() + max[d].capacity()) * sizeof(float);
+    }
+    return bytes;
+}
+
+void CompactAABBs::set(
+    const size_t i, const ArrayMax3d& _min, const ArrayMax3d& _max)
+{
+    assert(_min.size() == m_dim && _max.size() == m_dim);
+    for (int d = 0; d < m_dim; d++) {
+        min[d][i] = round_down(_min[d]);
+        max[d][i] = round_up(_max[d]);
+    }
+}
+
+void CompactAABBs::set(
+    const size_t i, const CompactAABBs& other, const size_t j)
+{
+    assert(other.dim() == m_dim);
+    for (int d = 0; d < m_dim; d++) {
+        min[d][i] = other.min[d][j];
+        max[d][i] = other.max[d][j];
+    }
+    vertex_ids[i] = other.vertex_ids[j];
+}
+
+void CompactAABBs::set_union(const size_t i, const size_t j, const size_t k)
+{
+    for (int d = 0; d < m_dim; d++) {
+        min[d][i] = std::min(min[d][j], min[d][k]);
+        max[d][i] = std::max(max[d][j], max[d][k]);
+    }
+}
+
+AABB CompactAABBs::box(const size_t i) const
+{
+    ArrayMax3d _min(m_dim), _max(m_dim);
+    for (int d = 0; d < m_dim; d++) {
+        _min[d] = min[d][i];
+        _max[d] = max[d][i];
+    }
+    AABB aabb(_min, _max);
+    aabb.vertex_ids = { { vertex_ids[i][0], vertex_ids[i][1],
+                          vertex_ids[i][2] } };
+    return aabb;
+}
+
+uint32_t CompactAABBs::intersects_batch(
+    const size_t i,
+    const CompactAABBs& other,
+    const int* js,
+    const int count) const
+{
+    assert(dim() == other.dim());
+    assert(count >= 0 && count <= BATCH_SIZE);
+    if (count <= 0) {
+        return 0;
+    }
+#ifdef IPC_TOOLKIT_AABB_AVX2
+    static_assert(BATCH_SIZE == 8, "batch must fit in one AVX register");
+
+    // Pad the unused lanes with a valid index and mask them out at the end.
+    alignas(32) int ids[BATCH_SIZE];
+    for (int k = 0; k < BATCH_SIZE; k++) {
+        ids[k] = js[k < count ? k : 0];
+    }
+    const __m256i vids =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(ids));
+    const uint32_t valid = (uint32_t(1) << count) - 1;
+
+#ifdef IPC_TOOLKIT_AABB_AVX512
+    __mmask8 overlap = __mmask8(valid);
+    for (int d = 0; d < m_dim; d++) {
+        const __m256 other_min =
+            _mm256_i32gather_ps(other.min[d].data(), vids, sizeof(float));
+        const __m256 other_max =
+            _mm256_i32gather_ps(other.max[d].data(), vids, sizeof(float));
+        overlap = _mm256_mask_cmp_ps_mask(
+            overlap, other_min, _mm256_set1_ps(max[d][i]), _CMP_LE_OQ);
+        overlap = _mm256_mask_cmp_ps_mask(
+            overlap, _mm256_set1_ps(min[d][i]), other_max, _CMP_LE_OQ);
+    }
+    return uint32_t(overlap);
+#else
+    __m256 overlap = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int d = 0; d < m_dim; d++) {
+        const __m256 other_min =
+            _mm256_i32gather_ps(other.min[d].data(), vids, sizeof(float));
+        const __m256 other_max =
+            _mm256_i32gather_ps(other.max[d].data(), vids, sizeof(float));
+        overlap = _mm256_and_ps(
+            overlap,
+            _mm256_and_ps(
+                _mm256_cmp_ps(
+                    other_min, _mm256_set1_ps(max[d][i]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_set1_ps(min[d][i]), other_max, _CMP_LE_OQ)));
+    }
+    return uint32_t(_mm256_movemask_ps(overlap)) & valid;
+#endif
+#else
+    uint32_t overlap = 0;
+    for (int k = 0; k < count; k++) {
+        overlap |= uint32_t(intersects(i, other, js[k])) << k;
+    }
+    return overlap;
+#endif
+}
+
+uint32_t CompactAABBs::intersects_range(
+    const size_t i,
+    const CompactAABBs& other,
+    const size_t j_begin,
+    const int count) const
+{
+    assert(dim() == other.dim());
+    assert(count >= 0 && count <= BATCH_SIZE);
+    assert(j_begin + count <= other.size());
+    if (count <= 0) {
+        return 0;
+    }
+#ifdef IPC_TOOLKIT_AABB_AVX2
+    static_assert(BATCH_SIZE == 8, "batch must fit in one AVX register");
+    const uint32_t valid = (uint32_t(1) << count) - 1;
+
+#ifdef IPC_TOOLKIT_AABB_AVX512
+    // Masked loads do not touch memory past the end of the range.
+    __mmask8 overlap = __mmask8(valid);
+    for (int d = 0; d < m_dim; d++) {
+        const __m256 other_min =
+            _mm256_maskz_loadu_ps(overlap, other.min[d].data() + j_begin);
+        const __m256 other_max =
+            _mm256_maskz_loadu_ps(overlap, other.max[d].data() + j_begin);
+        overlap = _mm256_mask_cmp_ps_mask(
+            overlap, other_min, _mm256_set1_ps(max[d][i]), _CMP_LE_OQ);
+        overlap = _mm256_mask_cmp_ps_mask(
+            overlap, _mm256_set1_ps(min[d][i]), other_max, _CMP_LE_OQ);
+    }
+    return uint32_t(overlap);
+#else
+    // Masked loads do not touch memory past the end of the range.
+    const __m256i load_mask = _mm256_cmpgt_epi32(
+        _mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256 overlap = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int d = 0; d < m_dim; d++) {
+        const __m256 other_min =
+            _mm256_maskload_ps(other.min[d].data() + j_begin, load_mask);
+        const __m256 other_max =
+            _mm256_maskload_ps(other.max[d].data() + j_begin, load_mask);
+        overlap = _mm256_and_ps(
+            overlap,
+            _mm256_and_ps(
+                _mm256_cmp_ps(
+                    other_min, _mm256_set1_ps(max[d][i]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_set1_ps(min[d][i]), other_max, _CMP_LE_OQ)));
+    }
+    return uint32_t(_mm256_movemask_ps(overlap)) & valid;
+#endif
+#else
+    uint32_t overlap = 0;
+    for (int k = 0; k < count; k++) {
+        overlap |= uint32_t(intersects(i, other, j_begin + k)) << k;
+    }
+    return overlap;
+#endif
+}
+
+float CompactAABBs::round_down(const double x)
+{
+    float f = static_cast<float>(x); // rounds to nearest
+    if (double(f) > x) {
+        f = std::nextafter(f, -std::numeric_limits<float>::infinity());
+    }
+    return f;
+}
+
+float CompactAABBs::round_up(const double x)
+{
+    float f = static_cast<float>(x); // rounds to nearest
+    if (double(f) < x) {
+        f = std::nextafter(f, std::numeric_limits<float>::infinity());
+    }
+    return f;
+}
+
+// ============================================================================
+
 void build_vertex_boxes(
     const Eigen::MatrixXd& vertices,
     std::vector<AABB>& vertex_boxes,
@@ -133,4 +361,95 @@ void build_face_boxes(
         });
 }
 
-} // namespace ipc
\ No newline at end of file
+// ============================================================================
+
+void build_vertex_boxes(
+    const Eigen::MatrixXd& vertices,
+    CompactAABBs& vertex_boxes,
+    const double inflation_radius)
+{
+    vertex_boxes.resize(vertices.rows(), vertices.cols());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, vertices.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const AABB box =
+                    AABB::from_point(vertices.row(i), inflation_radius);
+                vertex_boxes.set(i, box.min, box.max);
+                vertex_boxes.vertex_ids[i] = { { int(i), -1, -1 } };
+            }
+        });
+}
+
+void build_vertex_boxes(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    CompactAABBs& vertex_boxes,
+    const double inflation_radius)
+{
+    vertex_boxes.resize(vertices_t0.rows(), vertices_t0.cols());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, vertices_t0.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const AABB box = AABB::from_point(
+                    vertices_t0.row(i), vertices_t1.row(i), inflation_radius);
+                vertex_boxes.set(i, box.min, box.max);
+                vertex_boxes.vertex_ids[i] = { { int(i), -1, -1 } };
+            }
+        });
+}
+
+void build_edge_boxes(
+    const CompactAABBs& vertex_boxes,
+    const Eigen::MatrixXi& edges,
+    CompactAABBs& edge_boxes)
+{
+    const int dim = vertex_boxes.dim();
+    edge_boxes.resize(edges.rows(), dim);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, edges.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const int e0 = edges(i, 0), e1 = edges(i, 1);
+                for (int d = 0; d < dim; d++) {
+                    edge_boxes.min[d][i] = std::min(
+                        vertex_boxes.min[d][e0], vertex_boxes.min[d][e1]);
+                    edge_boxes.max[d][i] = std::max(
+                        vertex_boxes.max[d][e0], vertex_boxes.max[d][e1]);
+                }
+                edge_boxes.vertex_ids[i] = { { e0, e1, -1 } };
+            }
+        });
+}
+
+void build_face_boxes(
+    const CompactAABBs& vertex_boxes,
+    const Eigen::MatrixXi& faces,
+    CompactAABBs& face_boxes)
+{
+    const int dim = vertex_boxes.dim();
+    face_boxes.resize(faces.rows(), dim);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, faces.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const int f0 = faces(i, 0), f1 = faces(i, 1), f2 = faces(i, 2);
+                for (int d = 0; d < dim; d++) {
+                    face_boxes.min[d][i] = std::min(
+                        { vertex_boxes.min[d][f0], vertex_boxes.min[d][f1],
+                          vertex_boxes.min[d][f2] });
+                    face_boxes.max[d][i] = std::max(
+                        { vertex_boxes.max[d][f0], vertex_boxes.max[d][f1],
+                          vertex_boxes.max[d][f2] });
+                }
+                face_boxes.vertex_ids[i] = { { f0, f1, f2 } };
+            }
+        });
+}
+
+} // namespace ipc
@@ -3,6 +3,8 @@
 #include <ipc/utils/eigen_ext.hpp>
 
 #include <array>
+#include <cstdint>
+#include <vector>
 
 namespace ipc {
 
@@ -65,6 +67,121 @@ public:
     std::array<long, 3> vertex_ids;
 };
 
+/// @brief Structure-of-arrays storage of many AABBs in single precision.
+///
+/// The bounds are rounded conservatively (minimum corners down and maximum
+/// corners up), so overlap tests between compact boxes never miss an overlap
+/// of the original double precision boxes.
+class CompactAABBs {
+public:
+    /// @brief Maximum number of boxes tested at once by the batched overlap tests.
+    static constexpr int BATCH_SIZE = 8;
+
+    CompactAABBs() = default;
+
+    /// @brief Resize the storage.
+    /// @param size Number of boxes.
+    /// @param dim Dimension of the boxes (2 or 3).
+    void resize(const size_t size, const int dim);
+
+    /// @brief Clear all boxes.
+    void clear();
+
+    /// @brief Number of boxes stored.
+    size_t size() const { return vertex_ids.size(); }
+
+    /// @brief Dimension of the boxes.
+    int dim() const { return m_dim; }
+
+    /// @brief Number of bytes allocated to store the boxes.
+    size_t memory_usage() const;
+
+    /// @brief Set a box, rounding its corners conservatively to single precision.
+    /// @param i Index of the box to set.
+    /// @param min Minimum corner of the box.
+    /// @param max Maximum corner of the box.
+    void set(const size_t i, const ArrayMax3d& min, const ArrayMax3d& max);
+
+    /// @brief Set a box to a copy of a box from another storage.
+    /// @param i Index of the box to set.
+    /// @param other Storage to copy from.
+    /// @param j Index of the box to copy.
+    void set(const size_t i, const CompactAABBs& other, const size_t j);
+
+    /// @brief Set a box to the union of two boxes of this storage.
+    /// @param i Index of the box to set.
+    /// @param j Index of the first box.
+    /// @param k Index of the second box.
+    void set_union(const size_t i, const size_t j, const size_t k);
+
+    /// @brief Get a box in double precision (the conversion is exact).
+    /// @param i Index of the box.
+    /// @return The i-th box.
+    AABB box(const size_t i) const;
+
+    /// @brief Check if a box intersects a box of another storage.
+    /// @param i Index of the box in this storage.
+    /// @param other The other storage.
+    /// @param j Index of the box in the other storage.
+    /// @return If the two boxes intersect.
+    bool intersects(
+        const size_t i, const CompactAABBs& other, const size_t j) const
+    {
+        assert(dim() == other.dim());
+        // Combine the per-axis tests without branching.
+        bool overlap = true;
+        for (int d = 0; d < m_dim; d++) {
+            overlap &= (other.min[d][j] <= max[d][i])
+                & (min[d][i] <= other.max[d][j]);
+        }
+        return overlap;
+    }
+
+    /// @brief Check if a box intersects a batch of boxes of another storage.
+    /// @note Uses AVX-512 or AVX2 when built with IPC_TOOLKIT_WITH_SIMD.
+    /// @param i Index of the box in this storage.
+    /// @param other The other storage.
+    /// @param js Indices of the boxes in the other storage.
+    /// @param count Number of indices in js (at most BATCH_SIZE).
+    /// @return Bit mask whose k-th bit is set if box i intersects box js[k].
+    uint32_t intersects_batch(
+        const size_t i,
+        const CompactAABBs& other,
+        const int* js,
+        const int count) const;
+
+    /// @brief Check if a box intersects a contiguous range of boxes of another storage.
+    /// @note Uses AVX-512 or AVX2 when built with IPC_TOOLKIT_WITH_SIMD.
+    /// @param i Index of the box in this storage.
+    /// @param other The other storage.
+    /// @param j_begin Index of the first box in the other storage.
+    /// @param count Number of boxes in the range (at most BATCH_SIZE).
+    /// @return Bit mask whose k-th bit is set if box i intersects box j_begin + k.
+    uint32_t intersects_range(
+        const size_t i,
+        const CompactAABBs& other,
+        const size_t j_begin,
+        const int count) const;
+
+    /// @brief Round a value down to the closest single precision value.
+    static float round_down(const double x);
+
+    /// @brief Round a value up to the closest single precision value.
+    static float round_up(const double x);
+
+public:
+    /// @brief Minimum corner coordinates of the boxes (one array per axis).
+    std::array<std::vector<float>, 3> min;
+    /// @brief Maximum corner coordinates of the boxes (one array per axis).
+    std::array<std::vector<float>, 3> max;
+    /// @brief Vertex IDs attached to the boxes.
+    std::vector<std::array<int, 3>> vertex_ids;
+
+protected:
+    /// @brief Dimension of the boxes.
+    int m_dim = 0;
+};
+
 /// @brief Build one AABB per vertex position (row of V).
 /// @param[in] vertices Vertex positions (rowwise).
 /// @param[out] vertex_boxes Vertex AABBs.
@@ -103,4 +220,42 @@ void build_face_boxes(
     const Eigen::MatrixXi& faces,
     std::vector<AABB>& face_boxes);
 
+/// @brief Build one compact AABB per vertex position (row of V).
+/// @param[in] vertices Vertex positions (rowwise).
+/// @param[out] vertex_boxes Vertex AABBs.
+/// @param[in] inflation_radius Radius of a sphere around the points which the AABBs enclose.
+void build_vertex_boxes(
+    const Eigen::MatrixXd& vertices,
+    CompactAABBs& vertex_boxes,
+    const double inflation_radius = 0);
+
+/// @brief Build one compact AABB per vertex position moving linearly from t=0 to t=1.
+/// @param vertices_t0 Vertex positions at t=0 (rowwise).
+/// @param vertices_t1 Vertex positions at t=1 (rowwise).
+/// @param vertex_boxes Vertex AABBs.
+/// @param inflation_radius Radius of a capsule around the temporal edges which the AABBs enclose.
+void build_vertex_boxes(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    CompactAABBs& vertex_boxes,
+    const double inflation_radius = 0);
+
+/// @brief Build one compact AABB per edge.
+/// @param vertex_boxes Vertex AABBs.
+/// @param edges Edges (rowwise).
+/// @param edge_boxes Edge AABBs.
+void build_edge_boxes(
+    const CompactAABBs& vertex_boxes,
+    const Eigen::MatrixXi& edges,
+    CompactAABBs& edge_boxes);
+
+/// @brief Build one compact AABB per face.
+/// @param vertex_boxes Vertex AABBs.
+/// @param faces Faces (rowwise).
+/// @param face_boxes Face AABBs.
+void build_face_boxes(
+    const CompactAABBs& vertex_boxes,
+    const Eigen::MatrixXi& faces,
+    CompactAABBs& face_boxes);
+
 } // namespace ipc
@@ -0,0 +1,305 @@
+#include "auto_broad_phase.hpp"
+
+#include <ipc/broad_phase/voxel_size_heuristic.hpp>
+#include <ipc/candidates/candidates.hpp>
+#include <ipc/utils/logger.hpp>
+
+#include <chrono>
+
+namespace ipc {
+
+namespace {
+    /// Meshes with at most this many primitives use brute force.
+    constexpr size_t SMALL_MESH_NUM_PRIMITIVES = 256;
+    /// Ratio of the maximum to the average size above which sizes vary widely.
+    constexpr double SIZE_VARIATION_RATIO = 8;
+    /// Ratio of the displacement to the edge length below which motion is small.
+    constexpr double SMALL_MOTION_RATIO = 0.1;
+} // namespace
+
+BroadPhaseStatistics BroadPhaseStatistics::compute(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces)
+{
+    assert(vertices_t0.rows() == vertices_t1.rows());
+
+    BroadPhaseStatistics statistics;
+    statistics.num_vertices = vertices_t0.rows();
+    statistics.num_edges = edges.rows();
+    statistics.num_faces = faces.rows();
+
+    if (edges.rows() > 0) {
+        statistics.mean_edge_length = ipc::mean_edge_length(
+            vertices_t0, vertices_t1, edges,
+            statistics.edge_length_std_deviation);
+        statistics.max_edge_length =
+            ipc::max_edge_length(vertices_t0, vertices_t1, edges);
+    }
+
+    if (vertices_t0.rows() > 0) {
+        const Eigen::MatrixXd displacements = vertices_t1 - vertices_t0;
+        statistics.mean_displacement_length = ipc::mean_displacement_length(
+            displacements, statistics.displacement_length_std_deviation);
+        statistics.max_displacement_length =
+            ipc::max_displacement_length(displacements);
+    }
+
+    return statistics;
+}
+
+// ============================================================================
+
+void AutoBroadPhase::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    build(vertices, vertices, edges, faces, inflation_radius);
+}
+
+void AutoBroadPhase::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    const BroadPhaseStatistics statistics =
+        BroadPhaseStatistics::compute(vertices_t0, vertices_t1, edges, faces);
+    const BroadPhaseMethod method = select_method(statistics);
+
+    const bool is_cached = m_broad_phase != nullptr
+        && method == m_heuristic_method
+        && statistics.num_vertices == m_statistics.num_vertices
+        && statistics.num_edges == m_statistics.num_edges
+        && statistics.num_faces == m_statistics.num_faces;
+    m_statistics = statistics;
+
+    if (is_cached) {
+        copy_filters(*m_broad_phase);
+        m_broad_phase->build(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius);
+    } else {
+        build_selection(
+            method, vertices_t0, vertices_t1, edges, faces, inflation_radius);
+    }
+}
+
+void AutoBroadPhase::build_selection(
+    const BroadPhaseMethod method,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    m_heuristic_method = method;
+
+    if (!calibrate) {
+        m_selected_method = method;
+        m_broad_phase = make_broad_phase(method);
+        copy_filters(*m_broad_phase);
+        m_broad_phase->build(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius);
+        return;
+    }
+
+    // Every CPU method except brute force, which only competes on the small
+    // meshes the heuristic assigns to it.
+    std::vector<BroadPhaseMethod> methods = {
+        BroadPhaseMethod::HASH_GRID, BroadPhaseMethod::SPATIAL_HASH,
+        BroadPhaseMethod::BVH, BroadPhaseMethod::LBVH,
+        BroadPhaseMethod::SWEEP_AND_PRUNE
+    };
+    if (method == BroadPhaseMethod::BRUTE_FORCE) {
+        methods.push_back(BroadPhaseMethod::BRUTE_FORCE);
+    }
+
+    // Time a full build and candidate detection of each method and keep the
+    // fastest (already built) broad phase. Each trial records into its own
+    // profile so the shared profile only sees the selected broad phase.
+    const int dim = vertices_t0.cols();
+    double min_time = std::numeric_limits<double>::infinity();
+    m_broad_phase = nullptr;
+    for (const BroadPhaseMethod candidate_method : methods) {
+        std::shared_ptr<BroadPhase> broad_phase =
+            make_broad_phase(candidate_method);
+        copy_filters(*broad_phase);
+        if (profile != nullptr) {
+            broad_phase->profile = std::make_shared<BroadPhaseProfile>();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        broad_phase->build(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius);
+        Candidates candidates;
+        broad_phase->detect_collision_candidates(dim, candidates);
+        const double time = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+
+        logger().trace(
+            "broad phase calibration: method={:d} time={:g}s",
+            int(candidate_method), time);
+
+        if (time < min_time) {
+            min_time = time;
+            m_selected_method = candidate_method;
+            m_broad_phase = broad_phase;
+        }
+    }
+
+    if (profile != nullptr) {
+        // Keep the box statistics of the selected build.
+        profile->num_boxes = m_broad_phase->profile->num_boxes;
+        profile->memory_usage = m_broad_phase->profile->memory_usage;
+        profile->box_build_time = m_broad_phase->profile->box_build_time;
+        m_broad_phase->profile = profile;
+    }
+
+    logger().debug(
+        "broad phase calibration selected method {:d} (heuristic {:d})",
+        int(m_selected_method), int(method));
+}
+
+void AutoBroadPhase::clear()
+{
+    BroadPhase::clear();
+    m_broad_phase = nullptr;
+    m_selected_method = BroadPhaseMethod::AUTO;
+    m_heuristic_method = BroadPhaseMethod::AUTO;
+    m_statistics = BroadPhaseStatistics();
+}
+
+void AutoBroadPhase::copy_filters(BroadPhase& broad_phase) const
+{
+    broad_phase.can_vertices_collide = can_vertices_collide;
+    broad_phase.collision_groups = collision_groups;
+    broad_phase.is_vertex_static = is_vertex_static;
+    broad_phase.profile = profile;
+}
+
+// ============================================================================
+
+BroadPhaseMethod
+AutoBroadPhase::select_method(const BroadPhaseStatistics& statistics)
+{
+    const size_t num_primitives =
+        statistics.num_vertices + statistics.num_edges + statistics.num_faces;
+    if (num_primitives <= SMALL_MESH_NUM_PRIMITIVES) {
+        return BroadPhaseMethod::BRUTE_FORCE;
+    }
+
+    // Typical size of a box (without the inflation radius)
+    const double typical_size = std::max(
+        statistics.mean_edge_length + statistics.edge_length_std_deviation,
+        statistics.mean_displacement_length
+            + statistics.displacement_length_std_deviation);
+
+    if (typical_size > 0
+        && std::max(
+               statistics.max_edge_length, statistics.max_displacement_length)
+            > SIZE_VARIATION_RATIO * typical_size) {
+        return BroadPhaseMethod::BVH;
+    }
+
+    if (statistics.max_displacement_length
+        <= SMALL_MOTION_RATIO * statistics.mean_edge_length) {
+        return BroadPhaseMethod::SWEEP_AND_PRUNE;
+    }
+
+    return BroadPhaseMethod::HASH_GRID;
+}
+
+// ============================================================================
+
+void AutoBroadPhase::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_vertex_vertex_candidates(candidates);
+}
+
+void AutoBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_edge_vertex_candidates(candidates);
+}
+
+void AutoBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_edge_edge_candidates(candidates);
+}
+
+void AutoBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_face_vertex_candidates(candidates);
+}
+
+void AutoBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_edge_face_candidates(candidates);
+}
+
+void AutoBroadPhase::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->detect_face_face_candidates(candidates);
+}
+
+// ============================================================================
+
+void AutoBroadPhase::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_vertex_vertex_candidates(visitor);
+}
+
+void AutoBroadPhase::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_edge_vertex_candidates(visitor);
+}
+
+void AutoBroadPhase::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_edge_edge_candidates(visitor);
+}
+
+void AutoBroadPhase::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_face_vertex_candidates(visitor);
+}
+
+void AutoBroadPhase::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_edge_face_candidates(visitor);
+}
+
+void AutoBroadPhase::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    assert(m_broad_phase != nullptr);
+    m_broad_phase->visit_face_face_candidates(visitor);
+}
+
+} // namespace ipc
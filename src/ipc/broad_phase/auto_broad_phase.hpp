@@ -0,0 +1,202 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+
+namespace ipc {
+
+/// @brief Statistics of a mesh and its motion used to select a broad phase method.
+struct BroadPhaseStatistics {
+    /// @brief Compute the statistics of a mesh and its motion.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @return The statistics.
+    static BroadPhaseStatistics compute(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces);
+
+    /// @brief Number of vertices, edges, and faces.
+    size_t num_vertices = 0, num_edges = 0, num_faces = 0;
+    /// @brief Average edge length (over both time steps).
+    double mean_edge_length = 0;
+    /// @brief Standard deviation of the edge lengths.
+    double edge_length_std_deviation = 0;
+    /// @brief Maximum edge length.
+    double max_edge_length = 0;
+    /// @brief Average displacement length.
+    double mean_displacement_length = 0;
+    /// @brief Standard deviation of the displacement lengths.
+    double displacement_length_std_deviation = 0;
+    /// @brief Maximum displacement length.
+    double max_displacement_length = 0;
+};
+
+/// @brief Broad phase that selects the method from the mesh and motion statistics.
+///
+/// Each build computes cheap (linear time) statistics of the element sizes
+/// and displacements, maps them to a method with a heuristic (see
+/// select_method), and forwards all queries to a broad phase of that method.
+/// The selected broad phase is kept across builds as long as the heuristic
+/// keeps selecting the same method and the mesh size does not change, so
+/// methods that reuse data between builds keep doing so.
+///
+/// If calibrate is true, the first build of each new selection times the
+/// candidate methods (HASH_GRID, SPATIAL_HASH, BVH, LBVH, and SWEEP_AND_PRUNE,
+/// plus BRUTE_FORCE on small meshes) on the current input and caches the
+/// fastest one instead.
+///
+/// The cache lives in the AutoBroadPhase object. BroadPhaseMethod::AUTO
+/// passed to make_broad_phase (and so to the BroadPhaseMethod overloads of
+/// Candidates::build, is_step_collision_free, etc.) creates a new object per
+/// call, which re-runs the heuristic every time and never calibrates. To keep
+/// the selection across time steps (or to enable calibrate), keep an
+/// AutoBroadPhase and pass it to the BroadPhase& overloads instead.
+class AutoBroadPhase : public BroadPhase {
+public:
+    AutoBroadPhase() = default;
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Clear any built data (including the cached selection).
+    void clear() override;
+
+    /// @brief Find the candidate vertex-vertex collisions.
+    /// @param[out] candidates The candidate vertex-vertex collisions.
+    void detect_vertex_vertex_candidates(
+        std::vector<VertexVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-vertex collisions.
+    /// @param[out] candidates The candidate edge-vertex collisions.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-face collisions.
+    /// @param[out] candidates The candidate face-face collisions.
+    void detect_face_face_candidates(
+        std::vector<FaceFaceCandidate>& candidates) const override;
+
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+    /// @brief Select a broad phase method from the mesh and motion statistics.
+    ///
+    /// Small meshes use brute force. Widely varying element sizes or
+    /// displacements use a BVH, because the hash grid's voxel size is tuned
+    /// to the typical element size and long boxes span many voxels. Motions
+    /// that are small compared to the elements use sweep and prune. Everything
+    /// else uses the hash grid.
+    ///
+    /// @param statistics The mesh and motion statistics.
+    /// @return The selected method (never AUTO).
+    static BroadPhaseMethod
+    select_method(const BroadPhaseStatistics& statistics);
+
+    /// @brief Get the method currently selected (AUTO if not built).
+    BroadPhaseMethod selected_method() const { return m_selected_method; }
+
+    /// @brief Get the broad phase the queries are forwarded to (nullptr if not built).
+    const std::shared_ptr<BroadPhase>& selected_broad_phase() const
+    {
+        return m_broad_phase;
+    }
+
+    /// @brief Time the candidate methods on the first build of each new selection.
+    bool calibrate = false;
+
+protected:
+    /// @brief Create (or time and pick) the broad phase for a new selection and build it.
+    /// @param method Method selected by the heuristic.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build_selection(
+        const BroadPhaseMethod method,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius);
+
+    /// @brief Copy this broad phase's filters and profile to a broad phase.
+    void copy_filters(BroadPhase& broad_phase) const;
+
+    /// @brief Broad phase the queries are forwarded to.
+    std::shared_ptr<BroadPhase> m_broad_phase;
+    /// @brief Method of m_broad_phase.
+    BroadPhaseMethod m_selected_method = BroadPhaseMethod::AUTO;
+    /// @brief Method selected by the heuristic for the cached selection.
+    BroadPhaseMethod m_heuristic_method = BroadPhaseMethod::AUTO;
+    /// @brief Statistics of the last build.
+    BroadPhaseStatistics m_statistics;
+};
+
+} // namespace ipc
@@ -1,17 +1,47 @@
 #include "broad_phase.hpp"
 
+#include <ipc/broad_phase/auto_broad_phase.hpp>
 #include <ipc/broad_phase/brute_force.hpp>
 #include <ipc/broad_phase/bvh.hpp>
 #include <ipc/broad_phase/spatial_hash.hpp>
 #include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/broad_phase/lbvh.hpp>
 #include <ipc/broad_phase/sweep_and_prune.hpp>
 #include <ipc/broad_phase/sweep_and_tiniest_queue.hpp>
 #include <ipc/candidates/candidates.hpp>
 
 #include <ipc/config.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 namespace ipc {
 
+namespace {
+    /// @brief Seconds elapsed since a time point.
+    double seconds_since(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    /// @brief Stream stored candidates to a visitor in parallel.
+    template <typename Candidate>
+    void visit_candidates(
+        const std::vector<Candidate>& candidates,
+        const BroadPhase::CandidateVisitor<Candidate>& visitor)
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    visitor(candidates[i]);
+                }
+            });
+    }
+} // namespace
+
 void BroadPhase::build(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
@@ -21,9 +51,11 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
+    const auto start = std::chrono::steady_clock::now();
     build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
     build_edge_boxes(vertex_boxes, edges, edge_boxes);
     build_face_boxes(vertex_boxes, faces, face_boxes);
+    record_boxes(start);
 }
 
 void BroadPhase::build(
@@ -36,10 +68,25 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
+    const auto start = std::chrono::steady_clock::now();
     build_vertex_boxes(
         vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
     build_edge_boxes(vertex_boxes, edges, edge_boxes);
     build_face_boxes(vertex_boxes, faces, face_boxes);
+    record_boxes(start);
+}
+
+void BroadPhase::record_boxes(
+    const std::chrono::steady_clock::time_point& start) const
+{
+    if (!profile) {
+        return;
+    }
+    profile->num_boxes =
+        vertex_boxes.size() + edge_boxes.size() + face_boxes.size();
+    profile->memory_usage = vertex_boxes.memory_usage()
+        + edge_boxes.memory_usage() + face_boxes.memory_usage();
+    profile->box_build_time = seconds_since(start);
 }
 
 void BroadPhase::clear()
@@ -49,10 +96,62 @@ void BroadPhase::clear()
     face_boxes.clear();
 }
 
+// By default, the candidates are stored and then visited. Broad phases that
+// find candidates independently should stream them instead.
+
+void BroadPhase::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    std::vector<VertexVertexCandidate> candidates;
+    detect_vertex_vertex_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
+void BroadPhase::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    std::vector<EdgeVertexCandidate> candidates;
+    detect_edge_vertex_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
+void BroadPhase::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    std::vector<EdgeEdgeCandidate> candidates;
+    detect_edge_edge_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
+void BroadPhase::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    std::vector<FaceVertexCandidate> candidates;
+    detect_face_vertex_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
+void BroadPhase::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    std::vector<EdgeFaceCandidate> candidates;
+    detect_edge_face_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
+void BroadPhase::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    std::vector<FaceFaceCandidate> candidates;
+    detect_face_face_candidates(candidates);
+    visit_candidates(candidates, visitor);
+}
+
 void BroadPhase::detect_collision_candidates(
     int dim, Candidates& candidates) const
 {
     candidates.clear();
+    const auto start = std::chrono::steady_clock::now();
     if (dim == 2) {
         // This is not needed for 3D
         detect_edge_vertex_candidates(candidates.ev_candidates);
@@ -61,6 +160,10 @@ void BroadPhase::detect_collision_candidates(
         detect_edge_edge_candidates(candidates.ee_candidates);
         detect_face_vertex_candidates(candidates.fv_candidates);
     }
+    if (profile) {
+        profile->num_candidates = candidates.size();
+        profile->detect_time = seconds_since(start);
+    }
 }
 
 // ============================================================================
@@ -86,6 +189,10 @@ BroadPhase::make_broad_phase(const BroadPhaseMethod method)
 #endif
     case BroadPhaseMethod::BVH:
         return std::make_shared<BVH>();
+    case BroadPhaseMethod::LBVH:
+        return std::make_shared<LBVH>();
+    case BroadPhaseMethod::AUTO:
+        return std::make_shared<AutoBroadPhase>();
     default:
         throw std::runtime_error("Invalid BroadPhaseMethod!");
     }
@@ -93,71 +200,49 @@ BroadPhase::make_broad_phase(const BroadPhaseMethod method)
 
 // ============================================================================
 
-bool BroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
+bool BroadPhase::has_default_can_vertices_collide() const
 {
-    const auto& [e0i, e1i, _] = edge_boxes[ei].vertex_ids;
+    const auto* function_ptr =
+        can_vertices_collide.target<bool (*)(size_t, size_t)>();
+    return function_ptr != nullptr
+        && *function_ptr == &CollisionMesh::default_can_collide;
+}
+
+// The virtual filters use the combined (non-inlined) vertex filter.
 
-    return vi != e0i && vi != e1i
-        && (can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i));
+bool BroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
+{
+    return can_edge_vertex_collide(ei, vi, [this](size_t va, size_t vb) {
+        return can_vertex_pair_collide(va, vb);
+    });
 }
 
 bool BroadPhase::can_edges_collide(size_t eai, size_t ebi) const
 {
-    const auto& [ea0i, ea1i, _] = edge_boxes[eai].vertex_ids;
-    const auto& [eb0i, eb1i, __] = edge_boxes[ebi].vertex_ids;
-
-    const bool share_endpoint =
-        ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
-
-    return !share_endpoint
-        && (can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
-            || can_vertices_collide(ea1i, eb0i)
-            || can_vertices_collide(ea1i, eb1i));
+    return can_edges_collide(eai, ebi, [this](size_t va, size_t vb) {
+        return can_vertex_pair_collide(va, vb);
+    });
 }
 
 bool BroadPhase::can_face_vertex_collide(size_t fi, size_t vi) const
 {
-    const auto& [f0i, f1i, f2i] = face_boxes[fi].vertex_ids;
-
-    return vi != f0i && vi != f1i && vi != f2i
-        && (can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
-            || can_vertices_collide(vi, f2i));
+    return can_face_vertex_collide(fi, vi, [this](size_t va, size_t vb) {
+        return can_vertex_pair_collide(va, vb);
+    });
 }
 
 bool BroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
 {
-    const auto& [e0i, e1i, _] = edge_boxes[ei].vertex_ids;
-    const auto& [f0i, f1i, f2i] = face_boxes[fi].vertex_ids;
-
-    const bool share_endpoint = e0i == f0i || e0i == f1i || e0i == f2i
-        || e1i == f0i || e1i == f1i || e1i == f2i;
-
-    return !share_endpoint
-        && (can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
-            || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
-            || can_vertices_collide(e1i, f1i)
-            || can_vertices_collide(e1i, f2i));
+    return can_edge_face_collide(ei, fi, [this](size_t va, size_t vb) {
+        return can_vertex_pair_collide(va, vb);
+    });
 }
 
 bool BroadPhase::can_faces_collide(size_t fai, size_t fbi) const
 {
-    const auto& [fa0i, fa1i, fa2i] = face_boxes[fai].vertex_ids;
-    const auto& [fb0i, fb1i, fb2i] = face_boxes[fbi].vertex_ids;
-
-    const bool share_endpoint = fa0i == fb0i || fa0i == fb1i || fa0i == fb2i
-        || fa1i == fb0i || fa1i == fb1i || fa1i == fb2i || fa2i == fb0i
-        || fa2i == fb1i || fa2i == fb2i;
-
-    return !share_endpoint
-        && (can_vertices_collide(fa0i, fb0i) //
-            || can_vertices_collide(fa0i, fb1i)
-            || can_vertices_collide(fa0i, fb2i)
-            || can_vertices_collide(fa1i, fb0i)
-            || can_vertices_collide(fa1i, fb1i)
-            || can_vertices_collide(fa1i, fb2i)
-            || can_vertices_collide(fa2i, fb0i)
-            || can_vertices_collide(fa2i, fb1i)
-            || can_vertices_collide(fa2i, fb2i));
+    return can_faces_collide(fai, fbi, [this](size_t va, size_t vb) {
+        return can_vertex_pair_collide(va, vb);
+    });
 }
 
 } // namespace ipc
@@ -11,6 +11,9 @@
 
 #include <Eigen/Core>
 
+#include <chrono>
+#include <memory>
+
 namespace ipc {
 
 /// Enumeration of implemented broad phase methods.
@@ -19,7 +22,9 @@ enum class BroadPhaseMethod {
     HASH_GRID,
     SPATIAL_HASH,
     BVH,
+    LBVH,
     SWEEP_AND_PRUNE,
+    AUTO, // Selects one of the above from the mesh and motion statistics
     SWEEP_AND_TINIEST_QUEUE, // Requires CUDA
     NUM_METHODS
 };
@@ -29,11 +34,47 @@ static constexpr BroadPhaseMethod DEFAULT_BROAD_PHASE_METHOD =
 
 class Candidates; // Forward declaration
 
+/// @brief Counters and timings of a broad phase pass.
+///
+/// Used to tune the inflation radius and voxel sizes and to catch
+/// performance regressions. Each field is filled in by the function noted in
+/// its description; fields that were not computed are left at zero.
+struct BroadPhaseProfile {
+    /// @brief Number of boxes built (BroadPhase::build).
+    size_t num_boxes = 0;
+    /// @brief Number of bytes allocated for the boxes (BroadPhase::build).
+    size_t memory_usage = 0;
+    /// @brief Time in seconds to build the boxes (BroadPhase::build).
+    double box_build_time = 0;
+    /// @brief Time in seconds of the complete build, including any acceleration structure (Candidates::build).
+    double build_time = 0;
+    /// @brief Number of candidates emitted (BroadPhase::detect_collision_candidates and Candidates::build, including those rejected by its filter).
+    size_t num_candidates = 0;
+    /// @brief Time in seconds to find the candidates (BroadPhase::detect_collision_candidates).
+    double detect_time = 0;
+    /// @brief Number of candidates that passed the distance filter (Collisions::build) or CCD (Candidates::compute_collision_free_stepsize).
+    /// @note CCD only counts the collisions found before the running earliest time of impact.
+    size_t num_true_positives = 0;
+
+    /// @brief Fraction of the candidates that did not pass the narrow phase filter.
+    double false_positive_ratio() const
+    {
+        return num_candidates == 0
+            ? 0
+            : (1 - double(num_true_positives) / double(num_candidates));
+    }
+
+    /// @brief Reset all counters and timings to zero.
+    void reset() { *this = BroadPhaseProfile(); }
+};
+
 class BroadPhase {
 public:
     virtual ~BroadPhase() { clear(); }
 
     /// @brief Construct a registered broad phase object.
+    /// @note Each call returns a new object, so an AutoBroadPhase created here
+    ///       does not keep its selection between calls (see AutoBroadPhase).
     /// @param method The broad phase method to use.
     /// @return The constructed broad phase object.
     static std::shared_ptr<BroadPhase>
@@ -96,6 +137,44 @@ public:
     virtual void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const = 0;
 
+    /// @brief Function called on each candidate streamed by the broad phase.
+    /// @note The function may be called concurrently from multiple threads.
+    /// @note The default visit_*_candidates detect the candidates into a
+    /// vector and then visit them, which does not save their memory. The CPU
+    /// broad phases override them to stream the candidates instead.
+    template <typename Candidate>
+    using CandidateVisitor = std::function<void(const Candidate&)>;
+
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    virtual void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    virtual void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    virtual void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    virtual void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    virtual void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    virtual void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const;
+
     /// @brief Detect all collision candidates needed for a given dimensional simulation.
     /// @param dim The dimension of the simulation (i.e., 2 or 3).
     /// @param candidates The detected collision candidates.
@@ -104,20 +183,97 @@ public:
 
     /// @brief Function for determining if two vertices can collide.
     std::function<bool(size_t, size_t)> can_vertices_collide =
-        default_can_vertices_collide;
+        CollisionMesh::default_can_collide;
+
+    /// @brief Built-in collision groups of the vertices.
+    /// Two vertices can collide only if both collision_groups and
+    /// can_vertices_collide allow it.
+    CollisionGroups collision_groups;
+
+    /// @brief Flags marking the static vertices (see CollisionMesh::is_vertex_static).
+    /// By default (empty) no vertex is static. Only broad phases that separate
+    /// static geometry (e.g., StaticDynamicSplit) use them; broad phases that
+    /// wrap another broad phase forward them.
+    std::vector<bool> is_vertex_static;
+
+    /// @brief Profile filled in by build and detect_collision_candidates (nullptr to disable profiling).
+    std::shared_ptr<BroadPhaseProfile> profile;
 
 protected:
+    /// @brief Gives a visitor the interface of thread-local candidate vectors.
+    ///
+    /// The detection loops add candidates with storage.local().push_back(c),
+    /// so the same loop can fill a
+    /// tbb::enumerable_thread_specific<std::vector<Candidate>> (detect_*) or
+    /// stream the candidates to a visitor (visit_*).
+    template <typename Candidate> struct CandidateVisitorStorage {
+        /// @brief The storage is shared by all threads.
+        const CandidateVisitorStorage& local() const { return *this; }
+
+        /// @brief Pass a candidate to the visitor.
+        void push_back(const Candidate& candidate) const
+        {
+            visitor(candidate);
+        }
+
+        /// @brief Function called on each candidate.
+        const CandidateVisitor<Candidate>& visitor;
+    };
+
+    /// @brief Record the number, memory, and build time of the boxes in the profile (if any).
+    /// @param start Time point at which the boxes started being built.
+    void record_boxes(const std::chrono::steady_clock::time_point& start) const;
+
+    /// @brief Call a function with the cheapest vertex filter equivalent to collision_groups and can_vertices_collide.
+    /// The std::function is only used if it is not the default.
+    /// @param f Generic function taking the vertex filter as its argument.
+    template <typename F> void dispatch_vertex_filter(F&& f) const;
+
+    /// @brief Call a function with the inlinable filter for a candidate type.
+    /// @tparam Candidate Type of candidate collision to filter.
+    /// @param f Generic function taking the filter, a function of the two primitive ids, as its argument.
+    template <typename Candidate, typename F>
+    void dispatch_can_collide(F&& f) const;
+
+    /// @brief Is can_vertices_collide the default function (all vertices can collide)?
+    bool has_default_can_vertices_collide() const;
+
+    /// @brief Determine if two vertices can collide using collision_groups and can_vertices_collide.
+    bool can_vertex_pair_collide(size_t vi, size_t vj) const
+    {
+        return (collision_groups.empty() || collision_groups(vi, vj))
+            && can_vertices_collide(vi, vj);
+    }
+
     virtual bool can_edge_vertex_collide(size_t ei, size_t vi) const;
     virtual bool can_edges_collide(size_t eai, size_t ebi) const;
     virtual bool can_face_vertex_collide(size_t fi, size_t vi) const;
     virtual bool can_edge_face_collide(size_t ei, size_t fi) const;
     virtual bool can_faces_collide(size_t fai, size_t fbi) const;
 
-    static bool default_can_vertices_collide(size_t, size_t) { return true; }
+    // The following are the same as above, but with a given vertex filter.
+
+    template <typename VertexFilter>
+    bool can_edge_vertex_collide(
+        size_t ei, size_t vi, const VertexFilter& vertex_filter) const;
+    template <typename VertexFilter>
+    bool can_edges_collide(
+        size_t eai, size_t ebi, const VertexFilter& vertex_filter) const;
+    template <typename VertexFilter>
+    bool can_face_vertex_collide(
+        size_t fi, size_t vi, const VertexFilter& vertex_filter) const;
+    template <typename VertexFilter>
+    bool can_edge_face_collide(
+        size_t ei, size_t fi, const VertexFilter& vertex_filter) const;
+    template <typename VertexFilter>
+    bool can_faces_collide(
+        size_t fai, size_t fbi, const VertexFilter& vertex_filter) const;
 
-    std::vector<AABB> vertex_boxes;
-    std::vector<AABB> edge_boxes;
-    std::vector<AABB> face_boxes;
+    CompactAABBs vertex_boxes;
+    CompactAABBs edge_boxes;
+    CompactAABBs face_boxes;
 };
 
 } // namespace ipc
+
+#include "broad_phase.tpp"
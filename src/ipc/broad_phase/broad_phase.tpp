@@ -0,0 +1,132 @@
+#pragma once
+
+#include "broad_phase.hpp"
+
+#include <type_traits>
+
+namespace ipc {
+
+template <typename F> void BroadPhase::dispatch_vertex_filter(F&& f) const
+{
+    const bool is_default_function = has_default_can_vertices_collide();
+
+    if (collision_groups.empty()) {
+        if (is_default_function) {
+            f([](size_t, size_t) { return true; });
+        } else {
+            f(can_vertices_collide);
+        }
+    } else {
+        if (is_default_function) {
+            f(collision_groups);
+        } else {
+            f([this](size_t vi, size_t vj) {
+                return collision_groups(vi, vj) && can_vertices_collide(vi, vj);
+            });
+        }
+    }
+}
+
+template <typename Candidate, typename F>
+void BroadPhase::dispatch_can_collide(F&& f) const
+{
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        if constexpr (std::is_same_v<Candidate, VertexVertexCandidate>) {
+            f(vertex_filter);
+        } else if constexpr (std::is_same_v<Candidate, EdgeVertexCandidate>) {
+            f([&](size_t ei, size_t vi) {
+                return can_edge_vertex_collide(ei, vi, vertex_filter);
+            });
+        } else if constexpr (std::is_same_v<Candidate, EdgeEdgeCandidate>) {
+            f([&](size_t eai, size_t ebi) {
+                return can_edges_collide(eai, ebi, vertex_filter);
+            });
+        } else if constexpr (std::is_same_v<Candidate, FaceVertexCandidate>) {
+            f([&](size_t fi, size_t vi) {
+                return can_face_vertex_collide(fi, vi, vertex_filter);
+            });
+        } else if constexpr (std::is_same_v<Candidate, EdgeFaceCandidate>) {
+            f([&](size_t ei, size_t fi) {
+                return can_edge_face_collide(ei, fi, vertex_filter);
+            });
+        } else {
+            static_assert(std::is_same_v<Candidate, FaceFaceCandidate>);
+            f([&](size_t fai, size_t fbi) {
+                return can_faces_collide(fai, fbi, vertex_filter);
+            });
+        }
+    });
+}
+
+template <typename VertexFilter>
+bool BroadPhase::can_edge_vertex_collide(
+    size_t ei, size_t vi, const VertexFilter& vertex_filter) const
+{
+    const auto& [e0i, e1i, _] = edge_boxes.vertex_ids[ei];
+
+    return vi != e0i && vi != e1i
+        && (vertex_filter(vi, e0i) || vertex_filter(vi, e1i));
+}
+
+template <typename VertexFilter>
+bool BroadPhase::can_edges_collide(
+    size_t eai, size_t ebi, const VertexFilter& vertex_filter) const
+{
+    const auto& [ea0i, ea1i, _] = edge_boxes.vertex_ids[eai];
+    const auto& [eb0i, eb1i, __] = edge_boxes.vertex_ids[ebi];
+
+    const bool share_endpoint =
+        ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
+
+    return !share_endpoint
+        && (vertex_filter(ea0i, eb0i) || vertex_filter(ea0i, eb1i)
+            || vertex_filter(ea1i, eb0i) || vertex_filter(ea1i, eb1i));
+}
+
+template <typename VertexFilter>
+bool BroadPhase::can_face_vertex_collide(
+    size_t fi, size_t vi, const VertexFilter& vertex_filter) const
+{
+    const auto& [f0i, f1i, f2i] = face_boxes.vertex_ids[fi];
+
+    return vi != f0i && vi != f1i && vi != f2i
+        && (vertex_filter(vi, f0i) || vertex_filter(vi, f1i)
+            || vertex_filter(vi, f2i));
+}
+
+template <typename VertexFilter>
+bool BroadPhase::can_edge_face_collide(
+    size_t ei, size_t fi, const VertexFilter& vertex_filter) const
+{
+    const auto& [e0i, e1i, _] = edge_boxes.vertex_ids[ei];
+    const auto& [f0i, f1i, f2i] = face_boxes.vertex_ids[fi];
+
+    const bool share_endpoint = e0i == f0i || e0i == f1i || e0i == f2i
+        || e1i == f0i || e1i == f1i || e1i == f2i;
+
+    return !share_endpoint
+        && (vertex_filter(e0i, f0i) || vertex_filter(e0i, f1i)
+            || vertex_filter(e0i, f2i) || vertex_filter(e1i, f0i)
+            || vertex_filter(e1i, f1i) || vertex_filter(e1i, f2i));
+}
+
+template <typename VertexFilter>
+bool BroadPhase::can_faces_collide(
+    size_t fai, size_t fbi, const VertexFilter& vertex_filter) const
+{
+    const auto& [fa0i, fa1i, fa2i] = face_boxes.vertex_ids[fai];
+    const auto& [fb0i, fb1i, fb2i] = face_boxes.vertex_ids[fbi];
+
+    const bool share_endpoint = fa0i == fb0i || fa0i == fb1i || fa0i == fb2i
+        || fa1i == fb0i || fa1i == fb1i || fa1i == fb2i || fa2i == fb0i
+        || fa2i == fb1i || fa2i == fb2i;
+
+    return !share_endpoint
+        && (vertex_filter(fa0i, fb0i) //
+            || vertex_filter(fa0i, fb1i) || vertex_filter(fa0i, fb2i)
+            || vertex_filter(fa1i, fb0i) || vertex_filter(fa1i, fb1i)
+            || vertex_filter(fa1i, fb2i) || vertex_filter(fa2i, fb0i)
+            || vertex_filter(fa2i, fb1i) || vertex_filter(fa2i, fb2i));
+}
+
+} // namespace ipc
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+
+namespace ipc {
+
+/// @brief Restore the filters of a broad phase when going out of scope.
+///
+/// Used to temporarily replace the filters of a caller-owned broad phase,
+/// restoring them on every exit path (including exceptions).
+class BroadPhaseFilterGuard {
+public:
+    /// @brief Save the filters of a broad phase.
+    /// @param broad_phase Broad phase whose filters are restored on destruction.
+    explicit BroadPhaseFilterGuard(BroadPhase& broad_phase)
+        : m_broad_phase(broad_phase)
+        , m_can_vertices_collide(broad_phase.can_vertices_collide)
+        , m_collision_groups(broad_phase.collision_groups)
+    {
+    }
+
+    ~BroadPhaseFilterGuard()
+    {
+        m_broad_phase.can_vertices_collide = std::move(m_can_vertices_collide);
+        m_broad_phase.collision_groups = std::move(m_collision_groups);
+    }
+
+    BroadPhaseFilterGuard(const BroadPhaseFilterGuard&) = delete;
+    BroadPhaseFilterGuard& operator=(const BroadPhaseFilterGuard&) = delete;
+
+private:
+    BroadPhase& m_broad_phase;
+    std::function<bool(size_t, size_t)> m_can_vertices_collide;
+    CollisionGroups m_collision_groups;
+};
+
+} // namespace ipc
@@ -2,25 +2,24 @@
 
 #include <ipc/utils/merge_thread_local.hpp>
 
-#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range2d.h>
 
 #include <algorithm> // std::min/max
 
-using namespace std::placeholders;
-
 namespace ipc {
 
-template <typename Candidate, bool triangular>
+template <
+    typename Candidate,
+    bool triangular,
+    typename CanCollide,
+    typename Storage>
 void BruteForce::detect_candidates(
-    const std::vector<AABB>& boxes0,
-    const std::vector<AABB>& boxes1,
-    const std::function<bool(size_t, size_t)>& can_collide,
-    std::vector<Candidate>& candidates) const
+    const CompactAABBs& boxes0,
+    const CompactAABBs& boxes1,
+    const CanCollide& can_collide,
+    Storage& storage) const
 {
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-
     tbb::parallel_for(
         tbb::blocked_range2d<size_t>(0ul, boxes0.size(), 0ul, boxes1.size()),
         [&](const tbb::blocked_range2d<size_t>& r) {
@@ -34,7 +33,6 @@ void BruteForce::detect_candidates(
             }
 
             for (size_t i = r.rows().begin(); i < i_end; i++) {
-                const AABB& box0 = boxes0[i];
 
                 size_t j_begin;
                 if constexpr (triangular) {
@@ -44,70 +42,167 @@ void BruteForce::detect_candidates(
                     j_begin = r.cols().begin();
                 }
 
-                for (size_t j = j_begin; j < r.cols().end(); j++) {
-                    if (!can_collide(i, j)) {
-                        continue;
-                    }
-
-                    const AABB& box1 = boxes1[j];
-                    if (box0.intersects(box1)) {
-                        local_candidates.emplace_back(i, j);
+                for (size_t j = j_begin; j < r.cols().end();
+                     j += CompactAABBs::BATCH_SIZE) {
+                    const int count = int(std::min<size_t>(
+                        CompactAABBs::BATCH_SIZE, r.cols().end() - j));
+
+                    uint32_t overlaps =
+                        boxes0.intersects_range(i, boxes1, j, count);
+                    for (size_t k = j; overlaps != 0; k++, overlaps >>= 1) {
+                        if ((overlaps & 1) && can_collide(i, k)) {
+                            local_candidates.push_back(Candidate(i, k));
+                        }
                     }
                 }
             }
         });
+}
 
-    merge_thread_local_vectors(storage, candidates);
+template <typename Storage>
+void BruteForce::find_vertex_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<VertexVertexCandidate, true>(
+            vertex_boxes, vertex_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void BruteForce::find_edge_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate>(
+            edge_boxes, vertex_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void BruteForce::find_edge_edge_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeEdgeCandidate, true>(
+            edge_boxes, edge_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void BruteForce::find_face_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate>(
+            face_boxes, vertex_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void BruteForce::find_edge_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate>(
+            edge_boxes, face_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void BruteForce::find_face_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceFaceCandidate, true>(
+            face_boxes, face_boxes, can_collide, storage);
+    });
 }
 
+// ============================================================================
+
 void BruteForce::detect_vertex_vertex_candidates(
     std::vector<VertexVertexCandidate>& candidates) const
 {
-    detect_candidates<VertexVertexCandidate, true>(
-        vertex_boxes, vertex_boxes, can_vertices_collide, candidates);
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
 }
 
 void BruteForce::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
-    detect_candidates(
-        edge_boxes, vertex_boxes,
-        std::bind(&BruteForce::can_edge_vertex_collide, this, _1, _2),
-        candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
 }
 
 void BruteForce::detect_edge_edge_candidates(
     std::vector<EdgeEdgeCandidate>& candidates) const
 {
-    detect_candidates<EdgeEdgeCandidate, true>(
-        edge_boxes, edge_boxes,
-        std::bind(&BruteForce::can_edges_collide, this, _1, _2), candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
 }
 
 void BruteForce::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
-    detect_candidates(
-        face_boxes, vertex_boxes,
-        std::bind(&BruteForce::can_face_vertex_collide, this, _1, _2),
-        candidates);
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
 }
 
 void BruteForce::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
-    detect_candidates(
-        edge_boxes, face_boxes,
-        std::bind(&BruteForce::can_edge_face_collide, this, _1, _2),
-        candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
 }
 
 void BruteForce::detect_face_face_candidates(
     std::vector<FaceFaceCandidate>& candidates) const
 {
-    detect_candidates<FaceFaceCandidate, true>(
-        face_boxes, face_boxes,
-        std::bind(&BruteForce::can_faces_collide, this, _1, _2), candidates);
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BruteForce::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
 }
 
 } // namespace ipc
@@ -38,20 +38,72 @@ public:
     void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const override;
 
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
 private:
     /// @brief Detect candidates for collisions between two sets of boxes.
     /// @tparam Candidate Type of the candidate.
     /// @tparam triangular Whether to consider (i, j) and (j, i) as the same.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] boxes0 First set of boxes.
     /// @param[in] boxes1 Second set of boxes.
     /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
-    /// @param[out] candidates The candidate collisions.
-    template <typename Candidate, bool triangular = false>
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <
+        typename Candidate,
+        bool triangular = false,
+        typename CanCollide,
+        typename Storage>
     void detect_candidates(
-        const std::vector<AABB>& boxes0,
-        const std::vector<AABB>& boxes1,
-        const std::function<bool(size_t, size_t)>& can_collide,
-        std::vector<Candidate>& candidates) const;
+        const CompactAABBs& boxes0,
+        const CompactAABBs& boxes1,
+        const CanCollide& can_collide,
+        Storage& storage) const;
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
 };
 
 } // namespace ipc
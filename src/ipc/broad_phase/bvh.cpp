@@ -1,22 +1,53 @@
 #include "bvh.hpp"
 
 #include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/morton.hpp>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
 
-using namespace std::placeholders;
+#include <numeric>
 
 namespace ipc {
 
+namespace {
+    /// @brief Number of leaves below which a subtree is processed serially.
+    constexpr size_t SERIAL_GRAIN_SIZE = 1024;
+
+    /// @brief Maximum depth of the implicit tree (enough for 2^63 leaves).
+    constexpr size_t MAX_TREE_DEPTH = 64;
+
+    double surface_area(const CompactAABBs& boxes, const size_t i)
+    {
+        const double dx = double(boxes.max[0][i]) - boxes.min[0][i];
+        const double dy = double(boxes.max[1][i]) - boxes.min[1][i];
+        if (boxes.dim() == 2) {
+            return 2 * (dx + dy);
+        }
+        const double dz = double(boxes.max[2][i]) - boxes.min[2][i];
+        return 2 * (dx * dy + dy * dz + dz * dx);
+    }
+} // namespace
+
 void BVH::build(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
-    BroadPhase::build(vertices, edges, faces, inflation_radius);
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    // Only clear the boxes so the tree topology can be reused.
+    BroadPhase::clear();
+    const auto start = std::chrono::steady_clock::now();
+    build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+    record_boxes(start);
+
     init_bvh(vertex_boxes, vertex_bvh);
     init_bvh(edge_boxes, edge_bvh);
     init_bvh(face_boxes, face_bvh);
@@ -29,53 +60,182 @@ void BVH::build(
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
-    BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    // Only clear the boxes so the tree topology can be reused.
+    BroadPhase::clear();
+    const auto start = std::chrono::steady_clock::now();
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+    record_boxes(start);
+
     init_bvh(vertex_boxes, vertex_bvh);
     init_bvh(edge_boxes, edge_bvh);
     init_bvh(face_boxes, face_bvh);
 }
 
-void BVH::init_bvh(const std::vector<AABB>& boxes, SimpleBVH::BVH& bvh)
+void BVH::init_bvh(const CompactAABBs& boxes, Tree& tree) const
 {
-    if (boxes.size() == 0)
+    if (boxes.size() == 0) {
+        tree.clear();
         return;
+    }
 
-    std::vector<std::array<Eigen::Vector3d, 2>> vector_boxes(boxes.size());
-    for (int i = 0; i < boxes.size(); i++) {
-        vector_boxes[i] = { { to_3D(boxes[i].min), to_3D(boxes[i].max) } };
+    if (!enable_refit || tree.size() != boxes.size()) {
+        tree.build(boxes);
+        return;
     }
 
-    bvh.init(vector_boxes);
+    // Refit the existing topology and only rebuild if the quality degraded.
+    const double area = tree.refit(boxes);
+    if (area > rebuild_threshold * tree.built_area) {
+        tree.build(boxes);
+    }
 }
 
 void BVH::clear()
 {
+    BroadPhase::clear();
     vertex_bvh.clear();
     edge_bvh.clear();
     face_bvh.clear();
 }
 
-template <typename Candidate, bool swap_order, bool triangular>
+// ============================================================================
+
+void BVH::Tree::build(const CompactAABBs& boxes)
+{
+    assert(boxes.size() > 0);
+    const int dim = boxes.dim();
+
+    // Sort the boxes along a Morton curve through their centers.
+    Eigen::MatrixXd centers(boxes.size(), dim);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                for (int d = 0; d < dim; d++) {
+                    centers(i, d) =
+                        (double(boxes.min[d][i]) + boxes.max[d][i]) / 2;
+                }
+            }
+        });
+
+    std::vector<uint64_t> codes;
+    morton_codes(centers, codes);
+
+    leaf_to_box.resize(boxes.size());
+    std::iota(leaf_to_box.begin(), leaf_to_box.end(), 0);
+    tbb::parallel_sort(
+        leaf_to_box.begin(), leaf_to_box.end(),
+        [&](const unsigned int a, const unsigned int b) {
+            return codes[a] < codes[b] || (codes[a] == codes[b] && a < b);
+        });
+
+    // The implicit layout uses node ids < 4n (node 1 is the root).
+    nodes.resize(std::max(size_t(2), 4 * boxes.size()), dim);
+    built_area = refit(boxes);
+}
+
+double BVH::Tree::refit(const CompactAABBs& boxes)
+{
+    assert(boxes.size() == size());
+    return refit_node(boxes, 1, 0, boxes.size());
+}
+
+double BVH::Tree::refit_node(
+    const CompactAABBs& boxes, size_t n, size_t b, size_t e)
+{
+    assert(b < e);
+    if (b + 1 == e) {
+        nodes.set(n, boxes, leaf_to_box[b]);
+        return 0;
+    }
+
+    const size_t m = (b + e) / 2;
+    double left_area, right_area;
+    if (e - b > SERIAL_GRAIN_SIZE) {
+        tbb::parallel_invoke(
+            [&] { left_area = refit_node(boxes, 2 * n, b, m); },
+            [&] { right_area = refit_node(boxes, 2 * n + 1, m, e); });
+    } else {
+        left_area = refit_node(boxes, 2 * n, b, m);
+        right_area = refit_node(boxes, 2 * n + 1, m, e);
+    }
+
+    nodes.set_union(n, 2 * n, 2 * n + 1);
+    return left_area + right_area + surface_area(nodes, n);
+}
+
+void BVH::Tree::intersect_box(
+    const CompactAABBs& boxes,
+    const size_t i,
+    std::vector<unsigned int>& ids) const
+{
+    if (leaf_to_box.empty()) {
+        return;
+    }
+
+    // Depth-first traversal with a fixed size stack of (node, begin, end).
+    std::array<std::array<size_t, 3>, MAX_TREE_DEPTH + 1> stack;
+    size_t stack_size = 0;
+    stack[stack_size++] = { { 1, 0, leaf_to_box.size() } };
+
+    while (stack_size > 0) {
+        const auto [n, b, e] = stack[--stack_size];
+
+        if (!nodes.intersects(n, boxes, i)) {
+            continue;
+        }
+
+        if (b + 1 == e) {
+            ids.push_back(leaf_to_box[b]);
+            continue;
+        }
+
+        const size_t m = (b + e) / 2;
+        assert(stack_size + 2 <= stack.size());
+        stack[stack_size++] = { { 2 * n + 1, m, e } };
+        stack[stack_size++] = { { 2 * n, b, m } };
+    }
+}
+
+void BVH::Tree::clear()
+{
+    nodes.clear();
+    leaf_to_box.clear();
+    built_area = 0;
+}
+
+// ============================================================================
+
+template <
+    typename Candidate,
+    bool swap_order,
+    bool triangular,
+    typename CanCollide,
+    typename Storage>
 void BVH::detect_candidates(
-    const std::vector<AABB>& boxes,
-    const SimpleBVH::BVH& bvh,
-    const std::function<bool(size_t, size_t)>& can_collide,
-    std::vector<Candidate>& candidates)
+    const CompactAABBs& boxes,
+    const Tree& bvh,
+    const CanCollide& can_collide,
+    Storage& storage)
 {
     // O(n^2) or O(n^3) to build
     // O(klog(n)) to do a single look up
     // O(knlog(n)) to do all look ups
 
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), boxes.size()),
         [&](const tbb::blocked_range<size_t>& r) {
             auto& local_candidates = storage.local();
 
+            std::vector<unsigned int> js;
             for (size_t i = r.begin(); i < r.end(); i++) {
-                std::vector<unsigned int> js;
-                bvh.intersect_box(boxes[i].min, boxes[i].max, js);
+                js.clear();
+                bvh.intersect_box(boxes, i, js);
 
                 for (const unsigned int j : js) {
                     int ai = i, bi = j;
@@ -93,28 +253,28 @@ void BVH::detect_candidates(
                         continue;
                     }
 
-                    local_candidates.emplace_back(ai, bi);
+                    local_candidates.push_back(Candidate(ai, bi));
                 }
             }
         });
-
-    merge_thread_local_vectors(storage, candidates);
 }
 
-void BVH::detect_vertex_vertex_candidates(
-    std::vector<VertexVertexCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_vertex_vertex_candidates(Storage& storage) const
 {
     if (vertex_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates<
-        VertexVertexCandidate, /*swap_order=*/false, /*triangular=*/true>(
-        vertex_boxes, vertex_bvh, can_vertices_collide, candidates);
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            VertexVertexCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            vertex_boxes, vertex_bvh, can_collide, storage);
+    });
 }
 
-void BVH::detect_edge_vertex_candidates(
-    std::vector<EdgeVertexCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_edge_vertex_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0 || vertex_boxes.size() == 0) {
         return;
@@ -122,60 +282,158 @@ void BVH::detect_edge_vertex_candidates(
 
     // In 2D and for codimensional edge-vertex collisions, there are more
     // vertices than edges, so we want to iterate over the edges.
-    detect_candidates(
-        edge_boxes, vertex_bvh,
-        std::bind(&BVH::can_edge_vertex_collide, this, _1, _2), candidates);
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate>(
+            edge_boxes, vertex_bvh, can_collide, storage);
+    });
 }
 
-void BVH::detect_edge_edge_candidates(
-    std::vector<EdgeEdgeCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_edge_edge_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates<
-        EdgeEdgeCandidate, /*swap_order=*/false, /*triangular=*/true>(
-        edge_boxes, edge_bvh, std::bind(&BVH::can_edges_collide, this, _1, _2),
-        candidates);
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            EdgeEdgeCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            edge_boxes, edge_bvh, can_collide, storage);
+    });
 }
 
-void BVH::detect_face_vertex_candidates(
-    std::vector<FaceVertexCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_face_vertex_candidates(Storage& storage) const
 {
     if (face_boxes.size() == 0 || vertex_boxes.size() == 0) {
         return;
     }
 
     // The ratio vertices:faces is 1:2, so we want to iterate over the vertices.
-    detect_candidates<FaceVertexCandidate, /*swap_order=*/true>(
-        vertex_boxes, face_bvh,
-        std::bind(&BVH::can_face_vertex_collide, this, _1, _2), candidates);
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate, /*swap_order=*/true>(
+            vertex_boxes, face_bvh, can_collide, storage);
+    });
 }
 
-void BVH::detect_edge_face_candidates(
-    std::vector<EdgeFaceCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_edge_face_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0 || face_boxes.size() == 0) {
         return;
     }
 
     // The ratio edges:faces is 3:2, so we want to iterate over the faces.
-    detect_candidates<EdgeFaceCandidate, /*swap_order=*/true>(
-        face_boxes, edge_bvh,
-        std::bind(&BVH::can_edge_face_collide, this, _1, _2), candidates);
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate, /*swap_order=*/true>(
+            face_boxes, edge_bvh, can_collide, storage);
+    });
 }
 
-void BVH::detect_face_face_candidates(
-    std::vector<FaceFaceCandidate>& candidates) const
+template <typename Storage>
+void BVH::find_face_face_candidates(Storage& storage) const
 {
     if (face_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates<
-        FaceFaceCandidate, /*swap_order=*/false, /*triangular=*/true>(
-        face_boxes, face_bvh, std::bind(&BVH::can_faces_collide, this, _1, _2),
-        candidates);
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            FaceFaceCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            face_boxes, face_bvh, can_collide, storage);
+    });
+}
+
+// ============================================================================
+
+void BVH::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
+}
+
+void BVH::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
+}
+
+void BVH::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
+}
+
+void BVH::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
+}
+
+void BVH::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
 }
-} // namespace ipc
\ No newline at end of file
+
+void BVH::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void BVH::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
+}
+
+} // namespace ipc
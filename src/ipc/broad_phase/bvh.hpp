@@ -2,14 +2,29 @@
 
 #include <ipc/broad_phase/broad_phase.hpp>
 
-#include <SimpleBVH/BVH.hpp>
-
 namespace ipc {
 
+/// @brief Bounding volume hierarchy broad phase.
+///
+/// The tree is built by sorting the boxes along a Morton curve and splitting
+/// the sorted boxes in half recursively. When refitting is enabled, the tree
+/// topology is kept between calls to build and only the node bounds are
+/// updated. The tree is rebuilt when the summed surface area of its nodes grows
+/// beyond rebuild_threshold times the area at the last full build.
 class BVH : public BroadPhase {
 public:
     BVH() = default;
 
+    /// @brief Construct a BVH broad phase.
+    /// @param _enable_refit Keep the tree topology between builds and only refit the node bounds.
+    /// @param _rebuild_threshold Rebuild the tree when its summed node surface area exceeds this multiple of the area at the last full build.
+    explicit BVH(
+        const bool _enable_refit, const double _rebuild_threshold = 2.0)
+        : enable_refit(_enable_refit)
+        , rebuild_threshold(_rebuild_threshold)
+    {
+    }
+
     /// @brief Build the broad phase for static collision detection.
     /// @param vertices Vertex positions
     /// @param edges Collision mesh edges
@@ -34,7 +49,7 @@ public:
         const Eigen::MatrixXi& faces,
         const double inflation_radius = 0) override;
 
-    /// @brief Clear any built data.
+    /// @brief Clear any built data (including the persistent tree topology).
     void clear() override;
 
     /// @brief Find the candidate vertex-vertex collisions.
@@ -67,36 +82,134 @@ public:
     void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const override;
 
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+    /// @brief Keep the tree topology between builds and only refit the node bounds.
+    bool enable_refit = false;
+
+    /// @brief Rebuild a refitted tree when its summed node surface area exceeds this multiple of the area at the last full build.
+    double rebuild_threshold = 2.0;
+
+    /// @brief Implicit binary tree over a set of boxes.
+    ///
+    /// The root is node 1 and the children of node n are 2n and 2n+1. Node n
+    /// covers the sorted leaves [b, e) and its children cover [b, m) and
+    /// [m, e) with m = (b + e) / 2.
+    struct Tree {
+        /// @brief Build the tree topology and node bounds from scratch.
+        /// @param boxes The boxes to build the tree over.
+        void build(const CompactAABBs& boxes);
+
+        /// @brief Refit the node bounds to a new set of boxes, keeping the topology.
+        /// @param boxes The new boxes (must be the same number of boxes as the last build).
+        /// @return The summed surface area of the internal nodes after refitting.
+        double refit(const CompactAABBs& boxes);
+
+        /// @brief Find the ids of all boxes intersecting a query box.
+        /// @param[in] boxes The set of query boxes.
+        /// @param[in] i The index of the query box.
+        /// @param[out] ids The ids of the intersecting boxes.
+        void intersect_box(
+            const CompactAABBs& boxes,
+            const size_t i,
+            std::vector<unsigned int>& ids) const;
+
+        /// @brief Clear the tree.
+        void clear();
+
+        /// @brief Number of leaves in the tree.
+        size_t size() const { return leaf_to_box.size(); }
+
+        /// @brief Node bounding boxes.
+        CompactAABBs nodes;
+        /// @brief Box id of each leaf in sorted order.
+        std::vector<unsigned int> leaf_to_box;
+        /// @brief Summed surface area of the internal nodes at the last full build.
+        double built_area = 0;
+
+    private:
+        double
+        refit_node(const CompactAABBs& boxes, size_t n, size_t b, size_t e);
+    };
+
 protected:
-    /// @brief Initialize a BVH from a set of boxes.
-    /// @param[in] boxes Set of boxes to initialize the BVH with.
-    /// @param[out] bvh The BVH to initialize.
-    static void init_bvh(const std::vector<AABB>& boxes, SimpleBVH::BVH& bvh);
+    /// @brief Build or refit a tree from a set of boxes.
+    /// @param[in] boxes Set of boxes to initialize the tree with.
+    /// @param[in,out] tree The tree to initialize.
+    void init_bvh(const CompactAABBs& boxes, Tree& tree) const;
 
     /// @brief Detect candidate collisions between a BVH and a sets of boxes.
     /// @tparam Candidate Type of candidate collision.
     /// @tparam swap_order Whether to swap the order of box id with the BVH id when adding to the candidates.
     /// @tparam triangular Whether to consider (i, j) and (j, i) as the same.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] boxes The boxes to detect collisions with.
     /// @param[in] bvh The BVH to detect collisions with.
     /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
-    /// @param[out] candidates The candidate collisions.
+    /// @param[out] storage Storage the candidate collisions are added to.
     template <
         typename Candidate,
         bool swap_order = false,
-        bool triangular = false>
+        bool triangular = false,
+        typename CanCollide,
+        typename Storage>
     static void detect_candidates(
-        const std::vector<AABB>& boxes,
-        const SimpleBVH::BVH& bvh,
-        const std::function<bool(size_t, size_t)>& can_collide,
-        std::vector<Candidate>& candidates);
+        const CompactAABBs& boxes,
+        const Tree& bvh,
+        const CanCollide& can_collide,
+        Storage& storage);
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
 
     /// @brief BVH containing the vertices.
-    SimpleBVH::BVH vertex_bvh;
+    Tree vertex_bvh;
     /// @brief BVH containing the edges.
-    SimpleBVH::BVH edge_bvh;
+    Tree edge_bvh;
     /// @brief BVH containing the faces.
-    SimpleBVH::BVH face_bvh;
+    Tree face_bvh;
 };
 
-} // namespace ipc
\ No newline at end of file
+} // namespace ipc
@@ -3,6 +3,7 @@
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
 #include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/logger.hpp>
+#include <ipc/utils/radix_sort.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/blocked_range2d.h>
@@ -11,18 +12,30 @@
 
 #include <algorithm> // std::min/max
 
-#define IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE // else use unordered_set
-
-using namespace std::placeholders;
-
 namespace ipc {
 
+namespace {
+    /// @brief Number of bits needed to represent a value.
+    int bit_width(uint64_t x)
+    {
+        int width = 0;
+        for (; x != 0; x >>= 1) {
+            width++;
+        }
+        return width;
+    }
+} // namespace
+
 void HashGrid::build(
     const Eigen::MatrixXd& vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
+    if (enable_update && try_update(vertices, edges, faces, inflation_radius)) {
+        return;
+    }
+
     BroadPhase::build(vertices, edges, faces, inflation_radius);
     // BroadPhase::build also calls clear()
 
@@ -44,6 +57,12 @@ void HashGrid::build(
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
+    if (enable_update
+        && try_update(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius)) {
+        return;
+    }
+
     BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
     // BroadPhase::build also calls clear()
 
@@ -63,6 +82,178 @@ void HashGrid::build(
     insert_boxes();
 }
 
+void HashGrid::update(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    if (!try_update(vertices, edges, faces, inflation_radius)) {
+        build(vertices, edges, faces, inflation_radius);
+    }
+}
+
+void HashGrid::update(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    if (!try_update(vertices_t0, vertices_t1, edges, faces, inflation_radius)) {
+        build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+    }
+}
+
+bool HashGrid::try_update(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    ArrayMax3d mesh_min = vertices.colwise().minCoeff().array();
+    ArrayMax3d mesh_max = vertices.colwise().maxCoeff().array();
+    AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
+
+    if (!can_update(mesh_min, mesh_max, vertices.rows(), edges, faces)) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const CompactAABBs old_vertex_boxes = std::move(vertex_boxes);
+    build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
+    update_boxes(old_vertex_boxes, edges, faces);
+    record_boxes(start);
+    return true;
+}
+
+bool HashGrid::try_update(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    const ArrayMax3d mesh_min_t0 = vertices_t0.colwise().minCoeff();
+    const ArrayMax3d mesh_max_t0 = vertices_t0.colwise().maxCoeff();
+    const ArrayMax3d mesh_min_t1 = vertices_t1.colwise().minCoeff();
+    const ArrayMax3d mesh_max_t1 = vertices_t1.colwise().maxCoeff();
+
+    ArrayMax3d mesh_min = mesh_min_t0.min(mesh_min_t1);
+    ArrayMax3d mesh_max = mesh_max_t0.max(mesh_max_t1);
+    AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
+
+    if (!can_update(mesh_min, mesh_max, vertices_t0.rows(), edges, faces)) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const CompactAABBs old_vertex_boxes = std::move(vertex_boxes);
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
+    update_boxes(old_vertex_boxes, edges, faces);
+    record_boxes(start);
+    return true;
+}
+
+bool HashGrid::can_update(
+    const ArrayMax3d& mesh_min,
+    const ArrayMax3d& mesh_max,
+    const size_t num_vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces) const
+{
+    return num_vertices > 0 && vertex_boxes.size() == num_vertices
+        && edge_boxes.size() == size_t(edges.rows())
+        && face_boxes.size() == size_t(faces.rows())
+        && mesh_min.size() == domain_min().size()
+        // Boxes up to a cell outside of the domain are clamped to its
+        // boundary cells, which is conservative.
+        && (mesh_min > domain_min() - cell_size()).all()
+        && (mesh_max < domain_max() + cell_size()).all();
+}
+
+void HashGrid::update_boxes(
+    const CompactAABBs& old_vertex_boxes,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces)
+{
+    update_items(old_vertex_boxes, vertex_boxes, vertex_items);
+
+    const CompactAABBs old_edge_boxes = std::move(edge_boxes);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    update_items(old_edge_boxes, edge_boxes, edge_items);
+
+    const CompactAABBs old_face_boxes = std::move(face_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+    update_items(old_face_boxes, face_boxes, face_items);
+}
+
+void HashGrid::update_items(
+    const CompactAABBs& old_boxes,
+    const CompactAABBs& boxes,
+    std::vector<HashItem>& items) const
+{
+    assert(old_boxes.size() == boxes.size());
+
+    // 1. Find the boxes whose range of cells changed.
+    std::vector<uint8_t> is_changed(boxes.size(), false);
+    tbb::enumerable_thread_specific<std::vector<long>> storage;
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, long(boxes.size())),
+        [&](const tbb::blocked_range<long>& range) {
+            auto& local_changed = storage.local();
+            ArrayMax3i old_min, old_max, new_min, new_max;
+            for (long i = range.begin(); i != range.end(); i++) {
+                cell_range(old_boxes.box(i), old_min, old_max);
+                cell_range(boxes.box(i), new_min, new_max);
+                if ((old_min != new_min).any() || (old_max != new_max).any()) {
+                    is_changed[i] = true;
+                    local_changed.push_back(i);
+                }
+            }
+        });
+
+    std::vector<long> changed;
+    merge_thread_local_vectors(storage, changed);
+
+    logger().trace(
+        "hash-grid update re-inserting {:d} of {:d} boxes", changed.size(),
+        boxes.size());
+
+    if (changed.empty()) {
+        return;
+    }
+
+    // 2. Remove the stale items (this keeps the remaining items sorted).
+    items.erase(
+        std::remove_if(
+            items.begin(), items.end(),
+            [&](const HashItem& item) { return is_changed[item.id]; }),
+        items.end());
+
+    // 3. Insert the changed boxes and merge their sorted items back in.
+    tbb::enumerable_thread_specific<std::vector<HashItem>> items_storage;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), changed.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_items = items_storage.local();
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                insert_box(boxes.box(changed[i]), changed[i], local_items);
+            }
+        });
+
+    std::vector<HashItem> new_items;
+    merge_thread_local_vectors(items_storage, new_items);
+    sort_items(new_items);
+
+    const long num_old_items = items.size();
+    items.insert(items.end(), new_items.begin(), new_items.end());
+    std::inplace_merge(
+        items.begin(), items.begin() + num_old_items, items.end(),
+        [](const HashItem& a, const HashItem& b) { return a.key < b.key; });
+}
+
 void HashGrid::resize(
     const ArrayMax3d& domain_min,
     const ArrayMax3d& domain_max,
@@ -90,7 +281,7 @@ void HashGrid::insert_boxes()
 }
 
 void HashGrid::insert_boxes(
-    const std::vector<AABB>& boxes, std::vector<HashItem>& items) const
+    const CompactAABBs& boxes, std::vector<HashItem>& items) const
 {
     tbb::enumerable_thread_specific<std::vector<HashItem>> storage;
 
@@ -99,31 +290,36 @@ void HashGrid::insert_boxes(
         [&](const tbb::blocked_range<long>& range) {
             auto& local_items = storage.local();
             for (long i = range.begin(); i != range.end(); i++) {
-                insert_box(boxes[i], i, local_items);
+                insert_box(boxes.box(i), i, local_items);
             }
         });
 
     merge_thread_local_vectors(storage, items);
 
+    sort_items(items);
+}
+
+void HashGrid::sort_items(std::vector<HashItem>& items) const
+{
     // Sorted all they (key, value) pairs, where key is the hash key, and
     // value is the element index
-    tbb::parallel_sort(items.begin(), items.end());
+    if (use_radix_sort) {
+        // Only the keys need to be ordered, so sort by the cell key bits.
+        const int key_bits =
+            bit_width(uint64_t(grid_size().cast<long>().prod() - 1));
+        radix_sort(
+            items, [](const HashItem& item) { return uint64_t(item.key); },
+            key_bits);
+    } else {
+        tbb::parallel_sort(items.begin(), items.end());
+    }
 }
 
 void HashGrid::insert_box(
-    const AABB& aabb, const long id, std::vector<HashItem>& items) const
-{
-    ArrayMax3i int_min = ((aabb.min - domain_min()) / cell_size()).cast<int>();
-    // We can round down to -1, but not less
-    assert((int_min >= -1).all());
-    assert((int_min <= grid_size()).all());
-    int_min = int_min.max(0).min(grid_size() - 1);
-
-    ArrayMax3i int_max = ((aabb.max - domain_min()) / cell_size()).cast<int>();
-    assert((int_max >= -1).all());
-    assert((int_max <= grid_size()).all());
-    int_max = int_max.max(0).min(grid_size() - 1);
-    assert((int_min <= int_max).all());
+    const AABB& aabb, const index_t id, std::vector<HashItem>& items) const
+{
+    ArrayMax3i int_min, int_max;
+    cell_range(aabb, int_min, int_max);
 
     int min_z = int_min.size() == 3 ? int_min.z() : 0;
     int max_z = int_max.size() == 3 ? int_max.z() : 0;
@@ -136,14 +332,29 @@ void HashGrid::insert_box(
     }
 }
 
-template <typename Candidate>
+void HashGrid::cell_range(
+    const AABB& aabb, ArrayMax3i& int_min, ArrayMax3i& int_max) const
+{
+    const int dim = aabb.min.size();
+    int_min.resize(dim);
+    int_max.resize(dim);
+    for (int d = 0; d < dim; d++) {
+        int_min[d] = cell_index(aabb.min[d], d);
+        int_max[d] = cell_index(aabb.max[d], d);
+    }
+
+    assert((int_min >= 0).all() && (int_max < grid_size()).all());
+    assert((int_min <= int_max).all());
+}
+
+template <typename Candidate, typename CanCollide, typename Storage>
 void HashGrid::detect_candidates(
     const std::vector<HashItem>& items0,
     const std::vector<HashItem>& items1,
-    const std::vector<AABB>& boxes0,
-    const std::vector<AABB>& boxes1,
-    const std::function<bool(size_t, size_t)>& can_collide,
-    std::vector<Candidate>& candidates) const
+    const CompactAABBs& boxes0,
+    const CompactAABBs& boxes1,
+    const CanCollide& can_collide,
+    Storage& storage) const
 {
     // Entries with the same key means they share a cell (that cell index
     // hashes to the same key) and should be flagged for low-level intersection
@@ -176,13 +387,7 @@ void HashGrid::detect_candidates(
         return i < 0 ? items0[-(i + 1)] : items1[i];
     };
 
-    // 2. Enumerate hash collisions
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-#else
-    tbb::enumerable_thread_specific<unordered_set<Candidate>> storage;
-#endif
-
+    // 2. Enumerate the hash collisions reported by their cell
     tbb::parallel_for(
         tbb::blocked_range2d<long>(0l, num_items - 1, 0l, num_items),
         [&](const tbb::blocked_range2d<long>& r) {
@@ -194,6 +399,37 @@ void HashGrid::detect_candidates(
                 const long idx0 = merged_item_indices[i];
                 const HashItem& item0 = get_item(idx0);
 
+                // Test item0 against batches of items from the other set.
+                const CompactAABBs& query_boxes = idx0 < 0 ? boxes0 : boxes1;
+                const CompactAABBs& other_boxes = idx0 < 0 ? boxes1 : boxes0;
+                int batch[CompactAABBs::BATCH_SIZE];
+                int batch_size = 0;
+
+                const auto flush_batch = [&]() {
+                    uint32_t overlaps = query_boxes.intersects_batch(
+                        item0.id, other_boxes, batch, batch_size);
+                    for (int k = 0; overlaps != 0; k++, overlaps >>= 1) {
+                        if (!(overlaps & 1)) {
+                            continue;
+                        }
+
+                        long id0 = item0.id, id1 = batch[k];
+                        if (idx0 >= 0) {
+                            std::swap(id0, id1);
+                        }
+                        assert(id0 < boxes0.size() && id1 < boxes1.size());
+
+                        if (!is_reporting_cell(
+                                item0.key, boxes0, id0, boxes1, id1)
+                            || !can_collide(id0, id1)) {
+                            continue;
+                        }
+
+                        local_candidates.push_back(Candidate(id0, id1));
+                    }
+                    batch_size = 0;
+                };
+
                 // i < r.cols().end() → i + 1 <= r.cols().end()
                 long j_begin = std::max(i + 1, r.cols().begin());
                 for (long j = j_begin; j < r.cols().end(); j++) {
@@ -204,64 +440,32 @@ void HashGrid::detect_candidates(
                         break; // This avoids a brute force comparison
                     }
 
-                    long id0 = item0.id, id1 = item1.id;
-                    if (idx0 >= 0 && idx1 < 0) {
-                        std::swap(id0, id1);
-                    } else if (idx0 >= 0 || idx1 < 0) {
-                        continue;
+                    if ((idx0 < 0) == (idx1 < 0)) {
+                        continue; // Both items are from the same set
                     }
-                    assert(id0 < boxes0.size() && id1 < boxes1.size());
 
-                    if (!can_collide(id0, id1)) {
-                        continue;
-                    }
-
-                    if (boxes0[id0].intersects(boxes1[id1])) {
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(id0, id1);
-#else
-                        local_candidates.emplace(id0, id1);
-#endif
+                    batch[batch_size++] = item1.id;
+                    if (batch_size == CompactAABBs::BATCH_SIZE) {
+                        flush_batch();
                     }
                 }
+                flush_batch();
             }
         });
-
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    merge_thread_local_vectors(storage, candidates);
-
-    // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
-#else
-    unordered_set<Candidate> candidates_set;
-    merge_thread_local_unordered_sets(storage, candidates_set);
-
-    candidates.reserve(candidates_set.size());
-    candidates.insert(
-        candidates.end(), candidates_set.begin(), candidates_set.end());
-#endif
 }
 
-template <typename Candidate>
+template <typename Candidate, typename CanCollide, typename Storage>
 void HashGrid::detect_candidates(
     const std::vector<HashItem>& items,
-    const std::vector<AABB>& boxes,
-    const std::function<bool(size_t, size_t)>& can_collide,
-    std::vector<Candidate>& candidates) const
+    const CompactAABBs& boxes,
+    const CanCollide& can_collide,
+    Storage& storage) const
 {
     // Entries with the same key means they share a cell (that cell index
     // hashes to the same key) and should be flagged for low-level
     // intersection testing. So we loop over the entire sorted set of
     // (key,value) pairs creating Candidate entries for pairs with the same key
 
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-#else
-    tbb::enumerable_thread_specific<unordered_set<Candidate>> storage;
-#endif
-
     tbb::parallel_for(
         tbb::blocked_range2d<long>(0l, items.size() - 1, 0l, items.size()),
         [&](const tbb::blocked_range2d<long>& r) {
@@ -271,7 +475,30 @@ void HashGrid::detect_candidates(
             long i_end = std::min(r.rows().end(), r.cols().end());
             for (long i = r.rows().begin(); i < i_end; i++) {
                 const HashItem& item0 = items[i];
-                const AABB& box0 = boxes[item0.id];
+
+                // Test item0 against batches of items sharing its cell.
+                int batch[CompactAABBs::BATCH_SIZE];
+                int batch_size = 0;
+
+                const auto flush_batch = [&]() {
+                    uint32_t overlaps = boxes.intersects_batch(
+                        item0.id, boxes, batch, batch_size);
+                    for (int k = 0; overlaps != 0; k++, overlaps >>= 1) {
+                        if (!(overlaps & 1)) {
+                            continue;
+                        }
+
+                        if (!is_reporting_cell(
+                                item0.key, boxes, item0.id, boxes, batch[k])
+                            || !can_collide(item0.id, batch[k])) {
+                            continue;
+                        }
+
+                        local_candidates.push_back(
+                            Candidate(item0.id, batch[k]));
+                    }
+                    batch_size = 0;
+                };
 
                 // i < r.cols().end() → i + 1 <= r.cols().end()
                 long j_begin = std::max(i + 1, r.cols().begin());
@@ -283,86 +510,163 @@ void HashGrid::detect_candidates(
                         break; // This avoids a brute force comparison
                     }
 
-                    if (!can_collide(item0.id, item1.id)) {
-                        continue;
-                    }
-
-                    const AABB& box1 = boxes[item1.id];
-                    if (box0.intersects(box1)) {
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(item0.id, item1.id);
-#else
-                        local_candidates.emplace(item0.id, item1.id);
-#endif
+                    batch[batch_size++] = item1.id;
+                    if (batch_size == CompactAABBs::BATCH_SIZE) {
+                        flush_batch();
                     }
                 }
+                flush_batch();
             }
         });
+}
 
-#ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    merge_thread_local_vectors(storage, candidates);
+template <typename Storage>
+void HashGrid::find_vertex_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<VertexVertexCandidate>(
+            vertex_items, vertex_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void HashGrid::find_edge_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate>(
+            edge_items, vertex_items, edge_boxes, vertex_boxes, can_collide,
+            storage);
+    });
+}
+
+template <typename Storage>
+void HashGrid::find_edge_edge_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeEdgeCandidate>(
+            edge_items, edge_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void HashGrid::find_face_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate>(
+            face_items, vertex_items, face_boxes, vertex_boxes, can_collide,
+            storage);
+    });
+}
 
-    // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
-#else
-    unordered_set<Candidate> candidates_set;
-    merge_thread_local_unordered_sets(storage, candidates_set);
+template <typename Storage>
+void HashGrid::find_edge_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate>(
+            edge_items, face_items, edge_boxes, face_boxes, can_collide,
+            storage);
+    });
+}
 
-    candidates.reserve(candidates_set.size());
-    candidates.insert(
-        candidates.end(), candidates_set.begin(), candidates_set.end());
-#endif
+template <typename Storage>
+void HashGrid::find_face_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceFaceCandidate>(
+            face_items, face_boxes, can_collide, storage);
+    });
 }
 
+// ============================================================================
+
 void HashGrid::detect_vertex_vertex_candidates(
     std::vector<VertexVertexCandidate>& candidates) const
 {
-    detect_candidates(
-        vertex_items, vertex_boxes, can_vertices_collide, candidates);
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
 }
 
 void HashGrid::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
-    detect_candidates(
-        edge_items, vertex_items, edge_boxes, vertex_boxes,
-        std::bind(&HashGrid::can_edge_vertex_collide, this, _1, _2),
-        candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
 }
 
 void HashGrid::detect_edge_edge_candidates(
     std::vector<EdgeEdgeCandidate>& candidates) const
 {
-    detect_candidates(
-        edge_items, edge_boxes,
-        std::bind(&HashGrid::can_edges_collide, this, _1, _2), candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
 }
 
 void HashGrid::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
-    detect_candidates(
-        face_items, vertex_items, face_boxes, vertex_boxes,
-        std::bind(&HashGrid::can_face_vertex_collide, this, _1, _2),
-        candidates);
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
 }
 
 void HashGrid::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
-    detect_candidates(
-        edge_items, face_items, edge_boxes, face_boxes,
-        std::bind(&HashGrid::can_edge_face_collide, this, _1, _2), candidates);
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
 }
 
 void HashGrid::detect_face_face_candidates(
     std::vector<FaceFaceCandidate>& candidates) const
 {
-    detect_candidates(
-        face_items, face_boxes,
-        std::bind(&HashGrid::can_faces_collide, this, _1, _2), candidates);
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void HashGrid::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
 }
 
 } // namespace ipc
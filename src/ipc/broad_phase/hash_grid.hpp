@@ -2,17 +2,22 @@
 
 #include <ipc/broad_phase/broad_phase.hpp>
 
+#include <algorithm>
+#include <array>
+
 namespace ipc {
 
 /// @brief An entry into the hash grid as a (key, value) pair.
 struct HashItem {
     /// @brief The key of the item.
-    long key;
+    index_t key;
     /// @brief The value of the item.
-    long id;
+    index_t id;
+
+    HashItem() = default;
 
     /// @brief Construct a hash item as a (key, value) pair.
-    HashItem(int _key, int _id) : key(_key), id(_id) { }
+    HashItem(index_t _key, index_t _id) : key(_key), id(_id) { }
 
     /// @brief Compare HashItems by their keys for sorting.
     bool operator<(const HashItem& other) const
@@ -24,10 +29,22 @@ struct HashItem {
     }
 };
 
+/// @brief A uniform grid whose cells hold the ids of the boxes overlapping them.
+///
+/// Boxes spanning several cells are found once per shared cell, so each pair
+/// is only reported by one of the cells it shares (see is_reporting_cell).
+/// The candidates are therefore unique without sorting them and can be
+/// streamed (see visit_*_candidates).
 class HashGrid : public BroadPhase {
 public:
     HashGrid() = default;
 
+    /// @brief Construct a hash grid.
+    /// @param _use_radix_sort Sort the hash items with a parallel radix sort instead of a comparison sort.
+    explicit HashGrid(bool _use_radix_sort) : use_radix_sort(_use_radix_sort)
+    {
+    }
+
     /// @brief Build the broad phase for static collision detection.
     /// @param vertices Vertex positions
     /// @param edges Collision mesh edges
@@ -52,6 +69,40 @@ public:
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
 
+    /// @brief Update the hash grid for new positions of the same mesh.
+    ///
+    /// The cell size and domain of the last build are reused and only the
+    /// primitives whose range of cells changed are re-inserted. Falls back to
+    /// a full build if the mesh changed or moved more than a cell outside of
+    /// the domain of the grid.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0);
+
+    /// @brief Update the hash grid for new trajectories of the same mesh.
+    ///
+    /// The cell size and domain of the last build are reused and only the
+    /// primitives whose range of cells changed are re-inserted. Falls back to
+    /// a full build if the mesh changed or moved more than a cell outside of
+    /// the domain of the grid.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0);
+
     /// @brief Clear the hash grid.
     void clear() override
     {
@@ -90,11 +141,53 @@ public:
     void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const override;
 
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
     double cell_size() const { return m_cell_size; }
     const ArrayMax3i& grid_size() const { return m_grid_size; }
     const ArrayMax3d& domain_min() const { return m_domain_min; }
     const ArrayMax3d& domain_max() const { return m_domain_max; }
 
+    /// @brief Sort the hash items with a parallel radix sort.
+    ///
+    /// Items are sorted by their cell key only, so the sort needs only a few
+    /// passes.
+    bool use_radix_sort = true;
+
+    /// @brief Make build update the grid (see update) when possible.
+    ///
+    /// This lets a hash grid that is built repeatedly (e.g., passed to
+    /// Candidates::build) reuse its cells across builds.
+    bool enable_update = false;
+
 protected:
     void resize(
         const ArrayMax3d& domain_min,
@@ -104,14 +197,109 @@ protected:
     void insert_boxes();
 
     void insert_boxes(
-        const std::vector<AABB>& boxes, std::vector<HashItem>& items) const;
+        const CompactAABBs& boxes, std::vector<HashItem>& items) const;
 
     /// @brief Add an AABB of the extents to the hash grid.
     void insert_box(
-        const AABB& aabb, const long id, std::vector<HashItem>& items) const;
+        const AABB& aabb, const index_t id, std::vector<HashItem>& items) const;
+
+    /// @brief Sort the items by their keys.
+    void sort_items(std::vector<HashItem>& items) const;
+
+    /// @brief Update the hash grid for new positions of the same mesh if possible.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    /// @return False (leaving the grid unchanged) if the grid has to be rebuilt.
+    bool try_update(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius);
+
+    /// @brief Update the hash grid for new trajectories of the same mesh if possible.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    /// @return False (leaving the grid unchanged) if the grid has to be rebuilt.
+    bool try_update(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius);
+
+    /// @brief Check if the mesh can be updated without rebuilding the grid.
+    bool can_update(
+        const ArrayMax3d& mesh_min,
+        const ArrayMax3d& mesh_max,
+        const size_t num_vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces) const;
+
+    /// @brief Rebuild the boxes and re-insert the ones that changed cells.
+    /// @param old_vertex_boxes The vertex boxes of the last build or update.
+    void update_boxes(
+        const CompactAABBs& old_vertex_boxes,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces);
+
+    /// @brief Re-insert the boxes whose range of cells changed.
+    /// @param old_boxes Boxes before the update.
+    /// @param boxes Boxes after the update.
+    /// @param[in,out] items Sorted items of the boxes to patch.
+    void update_items(
+        const CompactAABBs& old_boxes,
+        const CompactAABBs& boxes,
+        std::vector<HashItem>& items) const;
+
+    /// @brief Compute the range of cells overlapped by an AABB.
+    void cell_range(
+        const AABB& aabb, ArrayMax3i& int_min, ArrayMax3i& int_max) const;
+
+    /// @brief Compute the cell containing a coordinate along an axis.
+    /// @param x Coordinate along the axis.
+    /// @param d Index of the axis.
+    /// @return Index of the cell along the axis (clamped to the grid).
+    inline int cell_index(double x, int d) const
+    {
+        // After an update, the (inflated) boxes can lie outside of the domain
+        // (see can_update), so clamp the cells to the grid.
+        return std::clamp(
+            int((x - domain_min()[d]) / cell_size()), 0, grid_size()[d] - 1);
+    }
+
+    /// @brief Check if a cell is the one that reports a pair of overlapping boxes.
+    ///
+    /// Overlapping boxes share every cell between the one containing the
+    /// maximum of their minimum corners and the one containing the minimum of
+    /// their maximum corners. Only the first of these cells reports the pair.
+    /// @param key Key of a cell shared by the boxes.
+    /// @param boxes0 First box's storage.
+    /// @param id0 First box's id.
+    /// @param boxes1 Second box's storage.
+    /// @param id1 Second box's id.
+    /// @return True if the pair should be reported from this cell.
+    inline bool is_reporting_cell(
+        const index_t key,
+        const CompactAABBs& boxes0,
+        const index_t id0,
+        const CompactAABBs& boxes1,
+        const index_t id1) const
+    {
+        std::array<int, 3> cell = { { 0, 0, 0 } };
+        for (int d = 0; d < boxes0.dim(); d++) {
+            cell[d] = cell_index(
+                std::max(boxes0.min[d][id0], boxes1.min[d][id1]), d);
+        }
+        return hash(cell[0], cell[1], cell[2]) == key;
+    }
 
     /// @brief Create the hash of a cell location.
-    inline long hash(int x, int y, int z) const
+    inline index_t hash(int x, int y, int z) const
     {
         assert(x >= 0 && y >= 0 && z >= 0);
         assert(
@@ -123,33 +311,53 @@ protected:
 private:
     /// @brief Find the candidate collisions between two sets of items.
     /// @tparam Candidate The type of collision candidate.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] items0 First set of items.
     /// @param[in] items1 Second set of items.
     /// @param[in] boxes0 First set's boxes.
     /// @param[in] boxes1 Second set's boxes.
     /// @param[in] can_collide Function to determine if two items can collide.
-    /// @param[out] candidates The candidate collisions.
-    template <typename Candidate>
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <typename Candidate, typename CanCollide, typename Storage>
     void detect_candidates(
         const std::vector<HashItem>& items0,
         const std::vector<HashItem>& items1,
-        const std::vector<AABB>& boxes0,
-        const std::vector<AABB>& boxes1,
-        const std::function<bool(size_t, size_t)>& can_collide,
-        std::vector<Candidate>& candidates) const;
+        const CompactAABBs& boxes0,
+        const CompactAABBs& boxes1,
+        const CanCollide& can_collide,
+        Storage& storage) const;
 
     /// @brief Find the candidate collisions among a set of items.
     /// @tparam Candidate The type of collision candidate.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] items The set of items.
     /// @param[in] boxes The items' boxes.
     /// @param[in] can_collide Function to determine if two items can collide.
-    /// @param[out] candidates The candidate collisions.
-    template <typename Candidate>
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <typename Candidate, typename CanCollide, typename Storage>
     void detect_candidates(
         const std::vector<HashItem>& items,
-        const std::vector<AABB>& boxes,
-        const std::function<bool(size_t, size_t)>& can_collide,
-        std::vector<Candidate>& candidates) const;
+        const CompactAABBs& boxes,
+        const CanCollide& can_collide,
+        Storage& storage) const;
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
 
 protected:
     double m_cell_size;
@@ -0,0 +1,464 @@
+#include "lbvh.hpp"
+
+#include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/morton.hpp>
+#include <ipc/utils/radix_sort.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+
+#include <atomic>
+
+namespace ipc {
+
+namespace {
+    int count_leading_zeros(uint64_t x)
+    {
+        if (x == 0) {
+            return 64;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(x);
+#else
+        int n = 0;
+        for (uint64_t mask = uint64_t(1) << 63; !(x & mask); mask >>= 1) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    /// @brief Load the minimum corner of a box padded to 3D.
+    Eigen::Array3f load_box_min(const CompactAABBs& boxes, const size_t i)
+    {
+        return Eigen::Array3f(
+            boxes.min[0][i], boxes.min[1][i],
+            boxes.dim() == 3 ? boxes.min[2][i] : 0.0f);
+    }
+
+    /// @brief Load the maximum corner of a box padded to 3D.
+    Eigen::Array3f load_box_max(const CompactAABBs& boxes, const size_t i)
+    {
+        return Eigen::Array3f(
+            boxes.max[0][i], boxes.max[1][i],
+            boxes.dim() == 3 ? boxes.max[2][i] : 0.0f);
+    }
+} // namespace
+
+void LBVH::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    BroadPhase::build(vertices, edges, faces, inflation_radius);
+    init_lbvh(vertex_boxes, vertex_lbvh);
+    init_lbvh(edge_boxes, edge_lbvh);
+    init_lbvh(face_boxes, face_lbvh);
+}
+
+void LBVH::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+    init_lbvh(vertex_boxes, vertex_lbvh);
+    init_lbvh(edge_boxes, edge_lbvh);
+    init_lbvh(face_boxes, face_lbvh);
+}
+
+void LBVH::clear()
+{
+    BroadPhase::clear();
+    vertex_lbvh.clear();
+    edge_lbvh.clear();
+    face_lbvh.clear();
+}
+
+void LBVH::init_lbvh(const CompactAABBs& boxes, std::vector<Node>& lbvh)
+{
+    lbvh.clear();
+
+    const int n = boxes.size();
+    if (n == 0) {
+        return;
+    }
+
+    // 1. Sort the boxes by the Morton codes of their centers.
+    std::vector<std::pair<uint64_t, int>> sorted_codes(n);
+    {
+        Eigen::MatrixXd centers(n, boxes.dim());
+        tbb::parallel_for(
+            tbb::blocked_range<int>(0, n),
+            [&](const tbb::blocked_range<int>& r) {
+                for (int i = r.begin(); i < r.end(); i++) {
+                    for (int d = 0; d < boxes.dim(); d++) {
+                        centers(i, d) =
+                            (double(boxes.min[d][i]) + boxes.max[d][i]) / 2;
+                    }
+                }
+            });
+
+        std::vector<uint64_t> codes;
+        morton_codes(centers, codes);
+
+        tbb::parallel_for(
+            tbb::blocked_range<int>(0, n),
+            [&](const tbb::blocked_range<int>& r) {
+                for (int i = r.begin(); i < r.end(); i++) {
+                    sorted_codes[i] = std::make_pair(codes[i], i);
+                }
+            });
+
+        // Stable, so boxes with equal codes stay ordered by id.
+        radix_sort(sorted_codes, [](const auto& p) { return p.first; });
+    }
+
+    // Internal nodes are [0, n-1) and leaves are [n-1, 2n-1).
+    lbvh.resize(2 * n - 1);
+    std::vector<int> parents(2 * n - 1, -1);
+
+    // 2. Initialize the leaves.
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, n), [&](const tbb::blocked_range<int>& r) {
+            for (int i = r.begin(); i < r.end(); i++) {
+                const int id = sorted_codes[i].second;
+                Node& leaf = lbvh[n - 1 + i];
+                leaf.min = load_box_min(boxes, id);
+                leaf.max = load_box_max(boxes, id);
+                leaf.right = id;
+            }
+        });
+
+    // 3. Build the internal nodes [Karras 2012].
+    // Length of the common prefix of the codes at i and j (ties broken by index)
+    const auto delta = [&](const int i, const int j) -> int {
+        if (j < 0 || j >= n) {
+            return -1;
+        }
+        const uint64_t ci = sorted_codes[i].first, cj = sorted_codes[j].first;
+        if (ci == cj) {
+            return 64 + count_leading_zeros(uint64_t(i ^ j));
+        }
+        return count_leading_zeros(ci ^ cj);
+    };
+
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, n - 1),
+        [&](const tbb::blocked_range<int>& r) {
+            for (int i = r.begin(); i < r.end(); i++) {
+                // Direction of the range
+                const int d = delta(i, i + 1) >= delta(i, i - 1) ? 1 : -1;
+
+                // Upper bound for the length of the range
+                const int delta_min = delta(i, i - d);
+                int l_max = 2;
+                while (delta(i, i + l_max * d) > delta_min) {
+                    l_max *= 2;
+                }
+
+                // Find the other end using binary search
+                int l = 0;
+                for (int t = l_max / 2; t >= 1; t /= 2) {
+                    if (delta(i, i + (l + t) * d) > delta_min) {
+                        l += t;
+                    }
+                }
+                const int j = i + l * d;
+
+                // Find the split position using binary search
+                const int delta_node = delta(i, j);
+                int s = 0;
+                for (int t = (l + 1) / 2;; t = (t + 1) / 2) {
+                    if (delta(i, i + (s + t) * d) > delta_node) {
+                        s += t;
+                    }
+                    if (t == 1) {
+                        break;
+                    }
+                }
+                const int gamma = i + s * d + std::min(d, 0);
+
+                Node& node = lbvh[i];
+                node.left = std::min(i, j) == gamma ? (n - 1 + gamma) : gamma;
+                node.right =
+                    std::max(i, j) == gamma + 1 ? (n + gamma) : (gamma + 1);
+                parents[node.left] = i;
+                parents[node.right] = i;
+            }
+        });
+
+    // 4. Compute the internal node bounds bottom-up. The second child to
+    // arrive at a parent computes its bounds and continues upwards.
+    std::vector<std::atomic<int>> visits(n - 1);
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, n), [&](const tbb::blocked_range<int>& r) {
+            for (int i = r.begin(); i < r.end(); i++) {
+                int node = parents[n - 1 + i];
+                while (node >= 0
+                       && visits[node].fetch_add(1, std::memory_order_acq_rel)
+                           == 1) {
+                    const Node& left = lbvh[lbvh[node].left];
+                    const Node& right = lbvh[lbvh[node].right];
+                    lbvh[node].min = left.min.min(right.min);
+                    lbvh[node].max = left.max.max(right.max);
+                    node = parents[node];
+                }
+            }
+        });
+
+    // 5. Compute the escape indices for stackless traversal. The escape of a
+    // node is the right sibling of its closest ancestor (or itself) which is
+    // a left child.
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, 2 * n - 1),
+        [&](const tbb::blocked_range<int>& r) {
+            for (int i = r.begin(); i < r.end(); i++) {
+                int child = i, parent = parents[i];
+                while (parent >= 0 && lbvh[parent].right == child) {
+                    child = parent;
+                    parent = parents[child];
+                }
+                lbvh[i].escape = parent < 0 ? -1 : lbvh[parent].right;
+            }
+        });
+}
+
+template <
+    typename Candidate,
+    bool swap_order,
+    bool triangular,
+    typename CanCollide,
+    typename Storage>
+void LBVH::detect_candidates(
+    const CompactAABBs& boxes,
+    const std::vector<Node>& lbvh,
+    const CanCollide& can_collide,
+    Storage& storage)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_candidates = storage.local();
+
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const Eigen::Array3f min = load_box_min(boxes, i);
+                const Eigen::Array3f max = load_box_max(boxes, i);
+
+                // Stackless traversal starting from the root
+                int node_id = 0;
+                while (node_id >= 0) {
+                    const Node& node = lbvh[node_id];
+                    if (!node.intersects(min, max)) {
+                        node_id = node.escape;
+                        continue;
+                    }
+                    if (!node.is_leaf()) {
+                        node_id = node.left;
+                        continue;
+                    }
+                    node_id = node.escape;
+
+                    int ai = i, bi = node.right;
+                    if constexpr (swap_order) {
+                        std::swap(ai, bi);
+                    }
+
+                    if constexpr (triangular) {
+                        if (ai >= bi) {
+                            continue;
+                        }
+                    }
+
+                    if (!can_collide(ai, bi)) {
+                        continue;
+                    }
+
+                    local_candidates.push_back(Candidate(ai, bi));
+                }
+            }
+        });
+}
+
+template <typename Storage>
+void LBVH::find_vertex_vertex_candidates(Storage& storage) const
+{
+    if (vertex_boxes.size() == 0) {
+        return;
+    }
+
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            VertexVertexCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            vertex_boxes, vertex_lbvh, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void LBVH::find_edge_vertex_candidates(Storage& storage) const
+{
+    if (edge_boxes.size() == 0 || vertex_boxes.size() == 0) {
+        return;
+    }
+
+    // In 2D and for codimensional edge-vertex collisions, there are more
+    // vertices than edges, so we want to iterate over the edges.
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate>(
+            edge_boxes, vertex_lbvh, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void LBVH::find_edge_edge_candidates(Storage& storage) const
+{
+    if (edge_boxes.size() == 0) {
+        return;
+    }
+
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            EdgeEdgeCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            edge_boxes, edge_lbvh, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void LBVH::find_face_vertex_candidates(Storage& storage) const
+{
+    if (face_boxes.size() == 0 || vertex_boxes.size() == 0) {
+        return;
+    }
+
+    // The ratio vertices:faces is 1:2, so we want to iterate over the vertices.
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate, /*swap_order=*/true>(
+            vertex_boxes, face_lbvh, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void LBVH::find_edge_face_candidates(Storage& storage) const
+{
+    if (edge_boxes.size() == 0 || face_boxes.size() == 0) {
+        return;
+    }
+
+    // The ratio edges:faces is 3:2, so we want to iterate over the faces.
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate, /*swap_order=*/true>(
+            face_boxes, edge_lbvh, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void LBVH::find_face_face_candidates(Storage& storage) const
+{
+    if (face_boxes.size() == 0) {
+        return;
+    }
+
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<
+            FaceFaceCandidate, /*swap_order=*/false, /*triangular=*/true>(
+            face_boxes, face_lbvh, can_collide, storage);
+    });
+}
+
+// ============================================================================
+
+void LBVH::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
+}
+
+void LBVH::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
+}
+
+void LBVH::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
+}
+
+void LBVH::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
+}
+
+void LBVH::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
+}
+
+void LBVH::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void LBVH::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
+}
+
+} // namespace ipc
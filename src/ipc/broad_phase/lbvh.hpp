@@ -0,0 +1,178 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+
+namespace ipc {
+
+/// @brief Linear bounding volume hierarchy broad phase.
+///
+/// The tree is built in parallel from radix-sorted Morton codes of the box
+/// centers following [Karras 2012]. Each node stores the index of the next node
+/// to visit when its subtree is skipped, so queries traverse the tree without a
+/// stack.
+class LBVH : public BroadPhase {
+public:
+    LBVH() = default;
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Clear any built data.
+    void clear() override;
+
+    /// @brief Find the candidate vertex-vertex collisions.
+    /// @param[out] candidates The candidate vertex-vertex collisions.
+    void detect_vertex_vertex_candidates(
+        std::vector<VertexVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-vertex collisions.
+    /// @param[out] candidates The candidate edge-vertex collisions.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-face collisions.
+    /// @param[out] candidates The candidate face-face collisions.
+    void detect_face_face_candidates(
+        std::vector<FaceFaceCandidate>& candidates) const override;
+
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+protected:
+    /// @brief Node of a linear BVH.
+    struct Node {
+        /// @brief Minimum corner of the node's bounding box.
+        Eigen::Array3f min;
+        /// @brief Maximum corner of the node's bounding box.
+        Eigen::Array3f max;
+        /// @brief Index of the left child or -1 if this is a leaf.
+        int left = -1;
+        /// @brief Index of the right child or the primitive id if this is a leaf.
+        int right = -1;
+        /// @brief Index of the node to visit after this subtree or -1 if none.
+        int escape = -1;
+
+        bool is_leaf() const { return left < 0; }
+
+        bool intersects(const Eigen::Array3f& _min, const Eigen::Array3f& _max)
+            const
+        {
+            return (min <= _max).all() && (_min <= max).all();
+        }
+    };
+
+    /// @brief Build a linear BVH over a set of boxes.
+    /// @param[in] boxes Set of boxes to build the tree over.
+    /// @param[out] lbvh The nodes of the tree (the root is node 0).
+    static void init_lbvh(const CompactAABBs& boxes, std::vector<Node>& lbvh);
+
+    /// @brief Detect candidate collisions between a linear BVH and a set of boxes.
+    /// @tparam Candidate Type of candidate collision.
+    /// @tparam swap_order Whether to swap the order of box id with the BVH id when adding to the candidates.
+    /// @tparam triangular Whether to consider (i, j) and (j, i) as the same.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
+    /// @param[in] boxes The boxes to detect collisions with.
+    /// @param[in] lbvh The linear BVH to detect collisions with.
+    /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <
+        typename Candidate,
+        bool swap_order = false,
+        bool triangular = false,
+        typename CanCollide,
+        typename Storage>
+    static void detect_candidates(
+        const CompactAABBs& boxes,
+        const std::vector<Node>& lbvh,
+        const CanCollide& can_collide,
+        Storage& storage);
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
+
+    /// @brief Linear BVH containing the vertices.
+    std::vector<Node> vertex_lbvh;
+    /// @brief Linear BVH containing the edges.
+    std::vector<Node> edge_lbvh;
+    /// @brief Linear BVH containing the faces.
+    std::vector<Node> face_lbvh;
+};
+
+} // namespace ipc
@@ -5,30 +5,27 @@
 #include <ipc/ccd/aabb.hpp>
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
 #include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/radix_sort.hpp>
 
 #include <ipc/config.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
-#include <tbb/parallel_sort.h>
 
-using namespace std::placeholders;
+#include <algorithm>
+#include <numeric>
 
 namespace ipc {
 
 namespace {
-    inline void tbb_parallel_block_range_for(
-        const size_t start_i,
-        const size_t end_i,
-        const std::function<void(size_t)>& body)
+    /// @brief Number of bits needed to represent a value.
+    int bit_width(uint64_t x)
     {
-        tbb::parallel_for(
-            tbb::blocked_range(start_i, end_i),
-            [&](const tbb::blocked_range<size_t>& range) {
-                for (size_t i = range.begin(); i != range.end(); i++) {
-                    body(i);
-                }
-            });
+        int width = 0;
+        for (; x != 0; x >>= 1) {
+            width++;
+        }
+        return width;
     }
 
     void fill_primitive_to_voxels(
@@ -36,13 +33,11 @@ namespace {
         const Eigen::Array3i& max_voxel,
         const ArrayMax3i& voxel_count,
         const int voxel_count_0x1,
-        std::vector<int>& primitive_to_voxels)
+        int* primitive_to_voxels)
     {
         assert((min_voxel <= max_voxel).all());
         assert(voxel_count_0x1 == voxel_count[0] * voxel_count[1]);
 
-        primitive_to_voxels.reserve((max_voxel - min_voxel + 1).prod());
-
         for (int iz = min_voxel[2]; iz <= max_voxel[2]; iz++) {
             int z_offset = iz * voxel_count_0x1;
 
@@ -50,24 +45,17 @@ namespace {
                 int yz_offset = iy * voxel_count[0] + z_offset;
 
                 for (int ix = min_voxel[0]; ix <= max_voxel[0]; ix++) {
-                    primitive_to_voxels.emplace_back(ix + yz_offset);
+                    *primitive_to_voxels++ = ix + yz_offset;
                 }
             }
         }
     }
 
-    void fill_voxel_to_primitives(
-        const size_t num_primitives,
-        const size_t primitive_offset,
-        const std::vector<std::vector<int>>& primitive_to_voxels,
-        unordered_map<int, std::vector<int>>& voxel_to_primitives)
-    {
-        for (int i = 0; i < num_primitives; i++) {
-            for (const auto& voxel : primitive_to_voxels[i]) {
-                voxel_to_primitives[voxel].emplace_back(i + primitive_offset);
-            }
-        }
-    }
+    /// @brief Reusable per-thread buffers for deduplicating query results.
+    struct QueryBuffers {
+        std::vector<int> stamps;
+        std::vector<int> ids;
+    };
 } // namespace
 
 void SpatialHash::build(
@@ -142,123 +130,111 @@ void SpatialHash::build(
 
     // ------------------------------------------------------------------------
 
-    point_to_voxels.resize(num_vertices);
-    tbb_parallel_block_range_for(0, num_vertices, [&](size_t vi) {
-        fill_primitive_to_voxels(
-            vertex_min_voxel_axis_index[vi], vertex_max_voxel_axis_index[vi],
-            voxel_count, voxel_count_0x1, point_to_voxels[vi]);
-    });
-
-    edge_to_voxels.resize(edges.rows());
-    tbb_parallel_block_range_for(0, edges.rows(), [&](size_t ei) {
-        fill_primitive_to_voxels(
-            vertex_min_voxel_axis_index[edges(ei, 0)].min(
-                vertex_min_voxel_axis_index[edges(ei, 1)]),
-            vertex_max_voxel_axis_index[edges(ei, 0)].max(
-                vertex_max_voxel_axis_index[edges(ei, 1)]),
-            voxel_count, voxel_count_0x1, edge_to_voxels[ei]);
-    });
-
-    face_to_voxels.resize(faces.rows());
-    tbb_parallel_block_range_for(0, faces.rows(), [&](size_t fi) {
-        fill_primitive_to_voxels(
-            vertex_min_voxel_axis_index[faces(fi, 0)]
-                .min(vertex_min_voxel_axis_index[faces(fi, 1)])
-                .min(vertex_min_voxel_axis_index[faces(fi, 2)]),
-            vertex_max_voxel_axis_index[faces(fi, 0)]
-                .max(vertex_max_voxel_axis_index[faces(fi, 1)])
-                .max(vertex_max_voxel_axis_index[faces(fi, 2)]),
-            voxel_count, voxel_count_0x1, face_to_voxels[fi]);
-    });
-
-    // ------------------------------------------------------------------------
-
     edge_start_ind = num_vertices;
     tri_start_ind = edge_start_ind + edges.rows();
-
-    fill_voxel_to_primitives(
-        num_vertices, 0, point_to_voxels, voxel_to_primitives);
-    fill_voxel_to_primitives(
-        edges.rows(), edge_start_ind, edge_to_voxels, voxel_to_primitives);
-    fill_voxel_to_primitives(
-        faces.rows(), tri_start_ind, face_to_voxels, voxel_to_primitives);
-}
-
-void SpatialHash::query_point_for_points(
-    int vi, unordered_set<int>& vert_ids) const
-{
-    vert_ids.clear();
-    for (const int voxel : point_to_voxels[vi]) {
-        for (const int id : voxel_to_primitives.at(voxel)) {
-            if (is_vertex_index(id) && id > vi) {
-                vert_ids.insert(id);
-            }
-        }
-    }
-}
-
-void SpatialHash::query_point_for_edges(
-    int vi, unordered_set<int>& edge_ids) const
-{
-    edge_ids.clear();
-    for (const int voxel : point_to_voxels[vi]) {
-        for (const int id : voxel_to_primitives.at(voxel)) {
-            if (is_edge_index(id)) {
-                edge_ids.insert(to_edge_index(id));
-            }
-        }
-    }
-}
-
-void SpatialHash::query_point_for_triangles(
-    int vi, unordered_set<int>& tri_ids) const
-{
-    tri_ids.clear();
-    for (const int voxel : point_to_voxels[vi]) {
-        for (const int id : voxel_to_primitives.at(voxel)) {
-            if (is_triangle_index(id)) {
-                tri_ids.insert(to_triangle_index(id));
-            }
+    const size_t num_primitives = tri_start_ind + faces.rows();
+
+    const auto primitive_voxel_range = [&](const size_t id,
+                                           Eigen::Array3i& min_voxel,
+                                           Eigen::Array3i& max_voxel) {
+        if (is_vertex_index(id)) {
+            min_voxel = vertex_min_voxel_axis_index[id];
+            max_voxel = vertex_max_voxel_axis_index[id];
+        } else if (is_edge_index(id)) {
+            const int ei = to_edge_index(id);
+            min_voxel = vertex_min_voxel_axis_index[edges(ei, 0)].min(
+                vertex_min_voxel_axis_index[edges(ei, 1)]);
+            max_voxel = vertex_max_voxel_axis_index[edges(ei, 0)].max(
+                vertex_max_voxel_axis_index[edges(ei, 1)]);
+        } else {
+            const int fi = to_triangle_index(id);
+            min_voxel = vertex_min_voxel_axis_index[faces(fi, 0)]
+                            .min(vertex_min_voxel_axis_index[faces(fi, 1)])
+                            .min(vertex_min_voxel_axis_index[faces(fi, 2)]);
+            max_voxel = vertex_max_voxel_axis_index[faces(fi, 0)]
+                            .max(vertex_max_voxel_axis_index[faces(fi, 1)])
+                            .max(vertex_max_voxel_axis_index[faces(fi, 2)]);
         }
-    }
-}
+    };
+
+    // Count the voxels of each primitive and lay them out contiguously.
+    primitive_voxel_offsets.assign(num_primitives + 1, 0);
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t id) {
+        Eigen::Array3i min_voxel, max_voxel;
+        primitive_voxel_range(id, min_voxel, max_voxel);
+        primitive_voxel_offsets[id + 1] = (max_voxel - min_voxel + 1).prod();
+    });
+    std::partial_sum(
+        primitive_voxel_offsets.begin(), primitive_voxel_offsets.end(),
+        primitive_voxel_offsets.begin());
+
+    struct VoxelEntry {
+        int voxel;
+        int primitive;
+        int entry;
+    };
+    std::vector<VoxelEntry> entries(primitive_voxel_offsets.back());
+
+    primitive_voxels.resize(entries.size());
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t id) {
+        Eigen::Array3i min_voxel, max_voxel;
+        primitive_voxel_range(id, min_voxel, max_voxel);
+        fill_primitive_to_voxels(
+            min_voxel, max_voxel, voxel_count, voxel_count_0x1,
+            primitive_voxels.data() + primitive_voxel_offsets[id]);
 
-// will only put edges with larger than eai index into edge_ids
-void SpatialHash::query_edge_for_edges(
-    int eai, unordered_set<int>& edge_ids) const
-{
-    edge_ids.clear();
-    for (const int voxel : edge_to_voxels[eai]) {
-        for (const int id : voxel_to_primitives.at(voxel)) {
-            if (is_edge_index(id) && to_edge_index(id) > eai) {
-                edge_ids.insert(to_edge_index(id));
-            }
+        for (int e = primitive_voxel_offsets[id];
+             e < primitive_voxel_offsets[id + 1]; e++) {
+            entries[e] = { primitive_voxels[e], int(id), e };
         }
-    }
-}
+    });
 
-void SpatialHash::query_edge_for_triangles(
-    int ei, unordered_set<int>& tri_ids) const
-{
-    tri_ids.clear();
-    for (const int voxel : edge_to_voxels[ei]) {
-        for (const auto& id : voxel_to_primitives.at(voxel)) {
-            if (is_triangle_index(id)) {
-                tri_ids.insert(to_triangle_index(id));
-            }
+    // Group the entries by voxel. The sort is stable, so the primitives of
+    // each voxel stay sorted by index.
+    const int max_voxel = primitive_voxels.empty()
+        ? 0
+        : *std::max_element(primitive_voxels.begin(), primitive_voxels.end());
+    radix_sort(
+        entries, [](const VoxelEntry& e) { return uint32_t(e.voxel); },
+        bit_width(max_voxel));
+
+    // Compress the occupied voxels and point the primitives at them.
+    voxel_primitives.resize(entries.size());
+    for (int k = 0; k < int(entries.size()); k++) {
+        if (k == 0 || entries[k].voxel != entries[k - 1].voxel) {
+            occupied_voxels.push_back(entries[k].voxel);
+            voxel_primitive_offsets.push_back(k);
         }
+        voxel_primitives[k] = entries[k].primitive;
+        primitive_voxels[entries[k].entry] = occupied_voxels.size() - 1;
     }
+    voxel_primitive_offsets.push_back(entries.size());
 }
 
-// will only put triangles with larger than fai index into tri_ids
-void SpatialHash::query_triangle_for_triangles(
-    int fai, unordered_set<int>& tri_ids) const
+void SpatialHash::query_primitives(
+    int primitive,
+    int begin,
+    int end,
+    int offset,
+    std::vector<int>& stamps,
+    std::vector<int>& ids) const
 {
-    tri_ids.clear();
-    for (const int voxel : face_to_voxels[fai]) {
-        for (const auto& id : voxel_to_primitives.at(voxel)) {
-            if (is_triangle_index(id) && to_triangle_index(id) > fai) {
-                tri_ids.insert(to_triangle_index(id));
+    ids.clear();
+    for (int e = primitive_voxel_offsets[primitive];
+         e < primitive_voxel_offsets[primitive + 1]; e++) {
+        const int voxel = primitive_voxels[e];
+        const auto first =
+            voxel_primitives.begin() + voxel_primitive_offsets[voxel];
+        const auto last =
+            voxel_primitives.begin() + voxel_primitive_offsets[voxel + 1];
+
+        // The primitives of a voxel are sorted, so skip to the first in range.
+        for (auto it = std::lower_bound(first, last, begin);
+             it != last && *it < end; ++it) {
+            int& stamp = stamps[*it - offset];
+            if (stamp != primitive) {
+                stamp = primitive;
+                ids.push_back(*it - offset);
             }
         }
     }
@@ -267,141 +243,259 @@ void SpatialHash::query_triangle_for_triangles(
 // ============================================================================
 // BroadPhase API
 
-template <typename Candidate, bool swap_order, bool triangular>
+template <
+    typename Candidate,
+    bool swap_order,
+    bool triangular,
+    typename CanCollide,
+    typename Storage>
 void SpatialHash::detect_candidates(
-    const std::vector<AABB>& boxesA,
-    const std::vector<AABB>& boxesB,
-    const std::function<void(int, unordered_set<int>&)>& query_A_for_Bs,
-    const std::function<bool(int, int)>& can_collide,
-    std::vector<Candidate>& candidates) const
+    const CompactAABBs& boxesA,
+    const CompactAABBs& boxesB,
+    const int offsetA,
+    const int offsetB,
+    const CanCollide& can_collide,
+    Storage& storage) const
 {
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+    tbb::enumerable_thread_specific<QueryBuffers> buffers;
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), boxesA.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storage.local();
+            auto& [stamps, js] = buffers.local();
+            if (stamps.empty()) {
+                stamps.assign(boxesB.size(), -1);
+            }
 
             for (size_t i = range.begin(); i != range.end(); i++) {
-                unordered_set<int> js;
-                query_A_for_Bs(i, js);
-
-                for (const int j : js) {
-                    int ai = i, bi = j;
+                int begin = offsetB, end = offsetB + int(boxesB.size());
+                if constexpr (triangular) {
+                    // Equivalent to ai < bi after swapping the order
                     if constexpr (swap_order) {
-                        std::swap(ai, bi);
+                        end = offsetB + int(i);
+                    } else {
+                        begin = offsetB + int(i) + 1;
                     }
+                }
+                query_primitives(offsetA + i, begin, end, offsetB, stamps, js);
 
-                    if constexpr (triangular) {
-                        if (ai >= bi) {
+                // Test box i against batches of the boxes found.
+                int batch[CompactAABBs::BATCH_SIZE];
+                int batch_size = 0;
+
+                const auto flush_batch = [&]() {
+                    uint32_t overlaps =
+                        boxesA.intersects_batch(i, boxesB, batch, batch_size);
+                    for (int k = 0; overlaps != 0; k++, overlaps >>= 1) {
+                        if (!(overlaps & 1)) {
                             continue;
                         }
-                    }
 
-                    if (!can_collide(ai, bi)) {
-                        continue;
+                        int ai = i, bi = batch[k];
+                        if constexpr (swap_order) {
+                            std::swap(ai, bi);
+                        }
+
+                        if (can_collide(ai, bi)) {
+                            local_candidates.push_back(Candidate(ai, bi));
+                        }
                     }
+                    batch_size = 0;
+                };
 
-                    if (boxesA[i].intersects(boxesB[j])) {
-                        local_candidates.emplace_back(ai, bi);
+                for (const int j : js) {
+                    batch[batch_size++] = j;
+                    if (batch_size == CompactAABBs::BATCH_SIZE) {
+                        flush_batch();
                     }
                 }
+                flush_batch();
             }
         });
-
-    merge_thread_local_vectors(storage, candidates);
 }
 
-template <typename Candidate>
+template <typename Candidate, typename CanCollide, typename Storage>
 void SpatialHash::detect_candidates(
-    const std::vector<AABB>& boxesA,
-    const std::function<void(int, unordered_set<int>&)>& query_A_for_As,
-    const std::function<bool(int, int)>& can_collide,
-    std::vector<Candidate>& candidates) const
+    const CompactAABBs& boxesA,
+    const int offsetA,
+    const CanCollide& can_collide,
+    Storage& storage) const
 {
     detect_candidates<Candidate, /*swap_order=*/false, /*triangular=*/true>(
-        boxesA, boxesA, query_A_for_As, can_collide, candidates);
+        boxesA, boxesA, offsetA, offsetA, can_collide, storage);
 }
 
-void SpatialHash::detect_vertex_vertex_candidates(
-    std::vector<VertexVertexCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_vertex_vertex_candidates(Storage& storage) const
 {
     if (vertex_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates(
-        vertex_boxes,
-        std::bind(&SpatialHash::query_point_for_points, this, _1, _2),
-        can_vertices_collide, candidates);
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<VertexVertexCandidate>(
+            vertex_boxes, 0, can_collide, storage);
+    });
 }
 
-void SpatialHash::detect_edge_vertex_candidates(
-    std::vector<EdgeVertexCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_edge_vertex_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0 || vertex_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates<EdgeVertexCandidate, /*swap_order=*/true>(
-        vertex_boxes, edge_boxes,
-        std::bind(&SpatialHash::query_point_for_edges, this, _1, _2),
-        std::bind(&SpatialHash::can_edge_vertex_collide, this, _1, _2),
-        candidates);
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate, /*swap_order=*/true>(
+            vertex_boxes, edge_boxes, 0, edge_start_ind, can_collide, storage);
+    });
 }
 
-void SpatialHash::detect_edge_edge_candidates(
-    std::vector<EdgeEdgeCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_edge_edge_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates(
-        edge_boxes, std::bind(&SpatialHash::query_edge_for_edges, this, _1, _2),
-        std::bind(&SpatialHash::can_edges_collide, this, _1, _2), candidates);
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeEdgeCandidate>(
+            edge_boxes, edge_start_ind, can_collide, storage);
+    });
 }
 
-void SpatialHash::detect_face_vertex_candidates(
-    std::vector<FaceVertexCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_face_vertex_candidates(Storage& storage) const
 {
     if (face_boxes.size() == 0 || vertex_boxes.size() == 0) {
         return;
     }
 
     // The ratio vertices:faces is 1:2, so we want to iterate over the vertices.
-    detect_candidates<FaceVertexCandidate, /*swap_order=*/true>(
-        vertex_boxes, face_boxes,
-        std::bind(&SpatialHash::query_point_for_triangles, this, _1, _2),
-        std::bind(&SpatialHash::can_face_vertex_collide, this, _1, _2),
-        candidates);
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate, /*swap_order=*/true>(
+            vertex_boxes, face_boxes, 0, tri_start_ind, can_collide, storage);
+    });
 }
 
-void SpatialHash::detect_edge_face_candidates(
-    std::vector<EdgeFaceCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_edge_face_candidates(Storage& storage) const
 {
     if (edge_boxes.size() == 0 || face_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates<EdgeFaceCandidate, /*swap_order=*/false>(
-        edge_boxes, face_boxes,
-        std::bind(&SpatialHash::query_edge_for_triangles, this, _1, _2),
-        std::bind(&SpatialHash::can_edge_face_collide, this, _1, _2),
-        candidates);
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate, /*swap_order=*/false>(
+            edge_boxes, face_boxes, edge_start_ind, tri_start_ind, can_collide,
+            storage);
+    });
 }
 
-void SpatialHash::detect_face_face_candidates(
-    std::vector<FaceFaceCandidate>& candidates) const
+template <typename Storage>
+void SpatialHash::find_face_face_candidates(Storage& storage) const
 {
     if (face_boxes.size() == 0) {
         return;
     }
 
-    detect_candidates(
-        face_boxes,
-        std::bind(&SpatialHash::query_triangle_for_triangles, this, _1, _2),
-        std::bind(&SpatialHash::can_faces_collide, this, _1, _2), candidates);
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceFaceCandidate>(
+            face_boxes, tri_start_ind, can_collide, storage);
+    });
+}
+
+// ============================================================================
+
+void SpatialHash::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
+}
+
+void SpatialHash::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
+}
+
+void SpatialHash::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
+}
+
+void SpatialHash::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
+}
+
+void SpatialHash::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
+}
+
+void SpatialHash::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SpatialHash::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
 }
 
 // ============================================================================
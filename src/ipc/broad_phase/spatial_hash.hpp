@@ -3,7 +3,6 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
-#include <ipc/utils/unordered_map_and_set.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 
 #include <vector>
@@ -32,17 +31,20 @@ public: // data
     // // The index of the first triangle in voxel_occupancies
     int tri_start_ind;
 
-    /// @brief Map from voxel index to the primitive indices it contains.
-    unordered_map<int, std::vector<int>> voxel_to_primitives;
+    /// @brief Sorted indices of the voxels containing at least one primitive.
+    std::vector<int> occupied_voxels;
 
-    /// @brief Map from point index to the voxel indices it occupies.
-    std::vector<std::vector<int>> point_to_voxels;
+    /// @brief Offsets of each occupied voxel's primitives in voxel_primitives.
+    std::vector<int> voxel_primitive_offsets;
 
-    /// @brief Map from edge index to the voxel indices it occupies.
-    std::vector<std::vector<int>> edge_to_voxels;
+    /// @brief Primitive indices contained in each occupied voxel (sorted).
+    std::vector<int> voxel_primitives;
 
-    /// @brief Map from face index to the voxel indices it occupies.
-    std::vector<std::vector<int>> face_to_voxels;
+    /// @brief Offsets of each primitive's voxels in primitive_voxels.
+    std::vector<int> primitive_voxel_offsets;
+
+    /// @brief Positions in occupied_voxels of the voxels of each primitive.
+    std::vector<int> primitive_voxels;
 
 protected:
     int dim;
@@ -114,10 +116,11 @@ public: // API
     void clear() override
     {
         BroadPhase::clear();
-        voxel_to_primitives.clear();
-        point_to_voxels.clear();
-        edge_to_voxels.clear();
-        face_to_voxels.clear();
+        occupied_voxels.clear();
+        voxel_primitive_offsets.clear();
+        voxel_primitives.clear();
+        primitive_voxel_offsets.clear();
+        primitive_voxels.clear();
     }
 
     /// @brief Check if primitive index refers to a vertex.
@@ -177,21 +180,51 @@ public: // API
     void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const override;
 
-protected: // helper functions
-    void query_point_for_points(int vi, unordered_set<int>& vert_inds) const;
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
 
-    void query_point_for_edges(int vi, unordered_set<int>& edge_inds) const;
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
 
-    void query_point_for_triangles(int vi, unordered_set<int>& tri_inds) const;
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
 
-    // will only put edges with larger than ei index into edge_inds
-    void query_edge_for_edges(int eai, unordered_set<int>& edge_inds) const;
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
 
-    void query_edge_for_triangles(int ei, unordered_set<int>& tri_inds) const;
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
 
-    // will only put triangles with larger than ti index into tri_inds
-    void
-    query_triangle_for_triangles(int ti, unordered_set<int>& tri_inds) const;
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+protected: // helper functions
+    /// @brief Find the primitives sharing a voxel with a primitive.
+    /// @param[in] primitive The primitive index to query.
+    /// @param[in] begin First primitive index to consider.
+    /// @param[in] end One past the last primitive index to consider.
+    /// @param[in] offset Offset subtracted from the primitive indices found.
+    /// @param[in,out] stamps Last primitive to find each index (minus offset). Must be initialized to -1 and reused across queries.
+    /// @param[out] ids The distinct primitive indices found minus offset.
+    void query_primitives(
+        int primitive,
+        int begin,
+        int end,
+        int offset,
+        std::vector<int>& stamps,
+        std::vector<int>& ids) const;
 
     int locate_voxel_index(const VectorMax3d& p) const;
 
@@ -214,31 +247,58 @@ private:
     /// @tparam Candidate Type of candidate collision.
     /// @tparam swap_order Whether to swap the order of A and B when adding to the candidates.
     /// @tparam triangular Whether to consider (i, j) and (j, i) as the same.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] boxesA The boxes of type A to detect collisions with.
     /// @param[in] boxesB The boxes of type B to detect collisions with.
-    /// @param[in] query_A_for_Bs Function to query boxes of type B for boxes of type A.
+    /// @param[in] offsetA The primitive index of the first box of type A.
+    /// @param[in] offsetB The primitive index of the first box of type B.
     /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
-    /// @param[out] candidates The candidate collisions.
-    template <typename Candidate, bool swap_order, bool triangular = false>
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <
+        typename Candidate,
+        bool swap_order,
+        bool triangular = false,
+        typename CanCollide,
+        typename Storage>
     void detect_candidates(
-        const std::vector<AABB>& boxesA,
-        const std::vector<AABB>& boxesB,
-        const std::function<void(int, unordered_set<int>&)>& query_A_for_Bs,
-        const std::function<bool(int, int)>& can_collide,
-        std::vector<Candidate>& candidates) const;
+        const CompactAABBs& boxesA,
+        const CompactAABBs& boxesB,
+        const int offsetA,
+        const int offsetB,
+        const CanCollide& can_collide,
+        Storage& storage) const;
 
     /// @brief Detect candidate collisions between type A and type A.
     /// @tparam Candidate Type of candidate collision.
+    /// @tparam CanCollide Type of the filter (see BroadPhase::dispatch_can_collide).
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
     /// @param[in] boxesA The boxes of type A to detect collisions with.
-    /// @param[in] query_A_for_As Function to query boxes of type A for boxes of type A.
+    /// @param[in] offsetA The primitive index of the first box of type A.
     /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
-    /// @param[out] candidates The candidate collisions.
-    template <typename Candidate>
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <typename Candidate, typename CanCollide, typename Storage>
     void detect_candidates(
-        const std::vector<AABB>& boxesA,
-        const std::function<void(int, unordered_set<int>&)>& query_A_for_As,
-        const std::function<bool(int, int)>& can_collide,
-        std::vector<Candidate>& candidates) const;
+        const CompactAABBs& boxesA,
+        const int offsetA,
+        const CanCollide& can_collide,
+        Storage& storage) const;
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
 };
 
 } // namespace ipc
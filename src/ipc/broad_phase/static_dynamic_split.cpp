@@ -0,0 +1,650 @@
+#include "static_dynamic_split.hpp"
+
+#include <ipc/utils/merge_thread_local.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+namespace ipc {
+
+namespace {
+    /// @brief Replace the local vertex ids of a set of boxes with global ids.
+    /// @param boxes The boxes whose vertex ids to replace.
+    /// @param local_to_global Global id of each local vertex id.
+    void to_global_vertex_ids(
+        CompactAABBs& boxes, const std::vector<int>& local_to_global)
+    {
+        for (auto& ids : boxes.vertex_ids) {
+            for (int& id : ids) {
+                if (id >= 0) {
+                    id = local_to_global[id];
+                }
+            }
+        }
+    }
+
+    /// @brief Select a subset of the rows of a primitive matrix and reindex their vertices.
+    /// @param primitives Edges or faces (rowwise).
+    /// @param ids Ids of the rows to select.
+    /// @param global_to_local New id of each vertex.
+    /// @return The selected and reindexed primitives.
+    Eigen::MatrixXi select_primitives(
+        const Eigen::MatrixXi& primitives,
+        const std::vector<int>& ids,
+        const std::vector<int>& global_to_local)
+    {
+        Eigen::MatrixXi selected(ids.size(), primitives.cols());
+        for (size_t i = 0; i < ids.size(); i++) {
+            for (int j = 0; j < primitives.cols(); j++) {
+                selected(i, j) = global_to_local[primitives(ids[i], j)];
+                assert(selected(i, j) >= 0);
+            }
+        }
+        return selected;
+    }
+
+    /// @brief Check if two primitives can collide given their vertex ids.
+    /// The primitives cannot collide if they share a vertex. Otherwise they
+    /// can collide if any pair of their vertices can.
+    /// @tparam N0 Number of vertices of the first primitive.
+    /// @tparam N1 Number of vertices of the second primitive.
+    template <int N0, int N1, typename VertexFilter>
+    bool can_primitives_collide(
+        const std::array<int, 3>& a,
+        const std::array<int, 3>& b,
+        const VertexFilter& vertex_filter)
+    {
+        for (int i = 0; i < N0; i++) {
+            for (int j = 0; j < N1; j++) {
+                if (a[i] == b[j]) {
+                    return false;
+                }
+            }
+        }
+        for (int i = 0; i < N0; i++) {
+            for (int j = 0; j < N1; j++) {
+                if (vertex_filter(a[i], b[j])) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// @brief Find the dynamic primitives overlapping the static primitives.
+    /// @tparam N0 Number of vertices of the dynamic primitives.
+    /// @tparam N1 Number of vertices of the static primitives.
+    /// @param dynamic_boxes Boxes of the dynamic primitives.
+    /// @param dynamic_ids Global ids of the dynamic primitives.
+    /// @param static_boxes Boxes of the static primitives.
+    /// @param static_ids Global ids of the static primitives.
+    /// @param static_bvh BVH of the static primitives.
+    /// @param is_static Function determining if a vertex is static.
+    /// @param vertex_filter Function determining if two vertices can collide.
+    /// @param make_candidate Function making the candidate from the global ids of a pair.
+    /// @param storage Storage the candidates are added to.
+    template <
+        int N0,
+        int N1,
+        typename IsStatic,
+        typename VertexFilter,
+        typename MakeCandidate,
+        typename Storage>
+    void detect_static_candidates(
+        const CompactAABBs& dynamic_boxes,
+        const std::vector<int>& dynamic_ids,
+        const CompactAABBs& static_boxes,
+        const std::vector<int>& static_ids,
+        const BVH::Tree& static_bvh,
+        const IsStatic& is_static,
+        const VertexFilter& vertex_filter,
+        const MakeCandidate& make_candidate,
+        Storage& storage)
+    {
+        if (static_bvh.size() == 0) {
+            return;
+        }
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), dynamic_boxes.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_candidates = storage.local();
+
+                std::vector<unsigned int> js;
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const std::array<int, 3>& a = dynamic_boxes.vertex_ids[i];
+
+                    // Static vertices of the dynamic broad phase are only
+                    // there to build the boxes of the dynamic primitives.
+                    if constexpr (N0 == 1) {
+                        if (is_static(a[0])) {
+                            continue;
+                        }
+                    }
+
+                    js.clear();
+                    static_bvh.intersect_box(dynamic_boxes, i, js);
+
+                    for (const unsigned int j : js) {
+                        if (can_primitives_collide<N0, N1>(
+                                a, static_boxes.vertex_ids[j], vertex_filter)) {
+                            local_candidates.push_back(make_candidate(
+                                dynamic_ids[i], static_ids[j]));
+                        }
+                    }
+                }
+            });
+    }
+} // namespace
+
+StaticDynamicSplit::StaticDynamicSplit(
+    std::shared_ptr<BroadPhase> dynamic_broad_phase)
+    : m_dynamic_broad_phase(std::move(dynamic_broad_phase))
+{
+    assert(m_dynamic_broad_phase != nullptr);
+}
+
+void StaticDynamicSplit::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    build_static(vertices, vertices, edges, faces, inflation_radius);
+
+    const auto start = std::chrono::steady_clock::now();
+    const Eigen::MatrixXd dynamic_vertices =
+        vertices(m_dynamic_vertices, Eigen::all);
+    build_vertex_boxes(dynamic_vertices, vertex_boxes, inflation_radius);
+    build_dynamic_boxes();
+    record_boxes(start);
+
+    update_dynamic_filters();
+    m_dynamic_broad_phase->build(
+        dynamic_vertices, m_local_dynamic_edges, m_local_dynamic_faces,
+        inflation_radius);
+}
+
+void StaticDynamicSplit::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    build_static(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+
+    const auto start = std::chrono::steady_clock::now();
+    const Eigen::MatrixXd dynamic_vertices_t0 =
+        vertices_t0(m_dynamic_vertices, Eigen::all);
+    const Eigen::MatrixXd dynamic_vertices_t1 =
+        vertices_t1(m_dynamic_vertices, Eigen::all);
+    build_vertex_boxes(
+        dynamic_vertices_t0, dynamic_vertices_t1, vertex_boxes,
+        inflation_radius);
+    build_dynamic_boxes();
+    record_boxes(start);
+
+    update_dynamic_filters();
+    m_dynamic_broad_phase->build(
+        dynamic_vertices_t0, dynamic_vertices_t1, m_local_dynamic_edges,
+        m_local_dynamic_faces, inflation_radius);
+}
+
+void StaticDynamicSplit::build_static(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    const size_t num_vertices = vertices_t0.rows();
+    const size_t num_edges = m_static_edges.size() + m_dynamic_edges.size();
+    const size_t num_faces = m_static_faces.size() + m_dynamic_faces.size();
+
+    if (m_is_static_built && m_num_vertices == num_vertices
+        && num_edges == size_t(edges.rows())
+        && num_faces == size_t(faces.rows())
+        && m_static_inflation_radius == inflation_radius
+        && m_built_is_vertex_static == is_vertex_static) {
+        m_was_static_rebuilt = false;
+        return; // Reuse the static BVHs
+    }
+
+    clear();
+    m_was_static_rebuilt = true;
+
+    // Partition the primitives
+    std::vector<bool> is_dynamic_vertex(num_vertices, false);
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+        if (is_static(vi)) {
+            m_static_vertices.push_back(vi);
+        } else {
+            is_dynamic_vertex[vi] = true;
+        }
+    }
+
+    for (int ei = 0; ei < edges.rows(); ei++) {
+        if (is_static(edges(ei, 0)) && is_static(edges(ei, 1))) {
+            m_static_edges.push_back(ei);
+        } else {
+            m_dynamic_edges.push_back(ei);
+            is_dynamic_vertex[edges(ei, 0)] = true;
+            is_dynamic_vertex[edges(ei, 1)] = true;
+        }
+    }
+
+    for (int fi = 0; fi < faces.rows(); fi++) {
+        if (is_static(faces(fi, 0)) && is_static(faces(fi, 1))
+            && is_static(faces(fi, 2))) {
+            m_static_faces.push_back(fi);
+        } else {
+            m_dynamic_faces.push_back(fi);
+            for (int j = 0; j < 3; j++) {
+                is_dynamic_vertex[faces(fi, j)] = true;
+            }
+        }
+    }
+
+    // The dynamic broad phase also needs the static vertices of the dynamic
+    // edges and faces to build their boxes.
+    std::vector<int> global_to_local(num_vertices, -1);
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+        if (is_dynamic_vertex[vi]) {
+            global_to_local[vi] = m_dynamic_vertices.size();
+            m_dynamic_vertices.push_back(vi);
+        }
+    }
+
+    m_local_dynamic_edges =
+        select_primitives(edges, m_dynamic_edges, global_to_local);
+    m_local_dynamic_faces =
+        select_primitives(faces, m_dynamic_faces, global_to_local);
+
+    // Build the static boxes and BVHs
+    for (size_t i = 0; i < m_static_vertices.size(); i++) {
+        global_to_local[m_static_vertices[i]] = i;
+    }
+
+    build_vertex_boxes(
+        vertices_t0(m_static_vertices, Eigen::all),
+        vertices_t1(m_static_vertices, Eigen::all), m_static_vertex_boxes,
+        inflation_radius);
+
+    build_edge_boxes(
+        m_static_vertex_boxes,
+        select_primitives(edges, m_static_edges, global_to_local),
+        m_static_edge_boxes);
+    build_face_boxes(
+        m_static_vertex_boxes,
+        select_primitives(faces, m_static_faces, global_to_local),
+        m_static_face_boxes);
+
+    to_global_vertex_ids(m_static_vertex_boxes, m_static_vertices);
+    to_global_vertex_ids(m_static_edge_boxes, m_static_vertices);
+    to_global_vertex_ids(m_static_face_boxes, m_static_vertices);
+
+    if (m_static_vertex_boxes.size()) {
+        m_static_vertex_bvh.build(m_static_vertex_boxes);
+    }
+    if (m_static_edge_boxes.size()) {
+        m_static_edge_bvh.build(m_static_edge_boxes);
+    }
+    if (m_static_face_boxes.size()) {
+        m_static_face_bvh.build(m_static_face_boxes);
+    }
+
+    m_is_static_built = true;
+    m_num_vertices = num_vertices;
+    m_static_inflation_radius = inflation_radius;
+    m_built_is_vertex_static = is_vertex_static;
+}
+
+void StaticDynamicSplit::build_dynamic_boxes()
+{
+    build_edge_boxes(vertex_boxes, m_local_dynamic_edges, edge_boxes);
+    build_face_boxes(vertex_boxes, m_local_dynamic_faces, face_boxes);
+
+    to_global_vertex_ids(vertex_boxes, m_dynamic_vertices);
+    to_global_vertex_ids(edge_boxes, m_dynamic_vertices);
+    to_global_vertex_ids(face_boxes, m_dynamic_vertices);
+}
+
+void StaticDynamicSplit::update_dynamic_filters()
+{
+    if (collision_groups.empty()) {
+        m_dynamic_broad_phase->collision_groups = CollisionGroups();
+    } else {
+        m_dynamic_broad_phase->collision_groups = collision_groups.select(
+            Eigen::Map<const Eigen::VectorXi>(
+                m_dynamic_vertices.data(), m_dynamic_vertices.size()));
+    }
+
+    if (has_default_can_vertices_collide()) {
+        m_dynamic_broad_phase->can_vertices_collide =
+            CollisionMesh::default_can_collide;
+    } else {
+        m_dynamic_broad_phase->can_vertices_collide =
+            [this](size_t vi, size_t vj) {
+                return can_vertices_collide(
+                    m_dynamic_vertices[vi], m_dynamic_vertices[vj]);
+            };
+    }
+}
+
+void StaticDynamicSplit::clear()
+{
+    BroadPhase::clear();
+    m_dynamic_broad_phase->clear();
+
+    m_is_static_built = false;
+    m_was_static_rebuilt = false;
+    m_static_inflation_radius = 0;
+    m_built_is_vertex_static.clear();
+    m_num_vertices = 0;
+
+    m_static_vertices.clear();
+    m_static_edges.clear();
+    m_static_faces.clear();
+    m_dynamic_vertices.clear();
+    m_dynamic_edges.clear();
+    m_dynamic_faces.clear();
+    m_local_dynamic_edges.resize(0, 2);
+    m_local_dynamic_faces.resize(0, 3);
+
+    m_static_vertex_boxes.clear();
+    m_static_edge_boxes.clear();
+    m_static_face_boxes.clear();
+    m_static_vertex_bvh.clear();
+    m_static_edge_bvh.clear();
+    m_static_face_bvh.clear();
+}
+
+
+// ============================================================================
+
+template <typename Candidate, typename Storage, typename Add>
+void StaticDynamicSplit::find_dynamic_candidates(
+    void (BroadPhase::*detect)(std::vector<Candidate>&) const,
+    void (BroadPhase::*visit)(const CandidateVisitor<Candidate>&) const,
+    Storage& storage,
+    const Add& add) const
+{
+    const BroadPhase& dynamic_broad_phase = *m_dynamic_broad_phase;
+    if constexpr (std::is_same_v<Storage, CandidateVisitorStorage<Candidate>>) {
+        (dynamic_broad_phase.*visit)(
+            [&](const Candidate& c) { add(storage, c); });
+    } else {
+        std::vector<Candidate> candidates;
+        (dynamic_broad_phase.*detect)(candidates);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_candidates = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    add(local_candidates, candidates[i]);
+                }
+            });
+    }
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_vertex_vertex_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_vertex_vertex_candidates,
+        &BroadPhase::visit_vertex_vertex_candidates, storage,
+        [&](auto& local_candidates, const VertexVertexCandidate& c) {
+            const int vi = m_dynamic_vertices[c.vertex0_id];
+            const int vj = m_dynamic_vertices[c.vertex1_id];
+            if (!is_static(vi) && !is_static(vj)) {
+                local_candidates.push_back(VertexVertexCandidate(vi, vj));
+            }
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<1, 1>(
+            vertex_boxes, m_dynamic_vertices, m_static_vertex_boxes,
+            m_static_vertices, m_static_vertex_bvh, is_static_vertex,
+            vertex_filter,
+            [](int vi, int vj) {
+                return VertexVertexCandidate(
+                    std::min(vi, vj), std::max(vi, vj));
+            },
+            storage);
+    });
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_edge_vertex_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_edge_vertex_candidates,
+        &BroadPhase::visit_edge_vertex_candidates, storage,
+        [&](auto& local_candidates, const EdgeVertexCandidate& c) {
+            const int vi = m_dynamic_vertices[c.vertex_id];
+            if (!is_static(vi)) {
+                local_candidates.push_back(
+                    EdgeVertexCandidate(m_dynamic_edges[c.edge_id], vi));
+            }
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<2, 1>(
+            edge_boxes, m_dynamic_edges, m_static_vertex_boxes,
+            m_static_vertices, m_static_vertex_bvh, is_static_vertex,
+            vertex_filter,
+            [](int ei, int vi) { return EdgeVertexCandidate(ei, vi); },
+            storage);
+        detect_static_candidates<1, 2>(
+            vertex_boxes, m_dynamic_vertices, m_static_edge_boxes,
+            m_static_edges, m_static_edge_bvh, is_static_vertex,
+            vertex_filter,
+            [](int vi, int ei) { return EdgeVertexCandidate(ei, vi); },
+            storage);
+    });
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_edge_edge_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_edge_edge_candidates,
+        &BroadPhase::visit_edge_edge_candidates, storage,
+        [&](auto& local_candidates, const EdgeEdgeCandidate& c) {
+            local_candidates.push_back(EdgeEdgeCandidate(
+                m_dynamic_edges[c.edge0_id], m_dynamic_edges[c.edge1_id]));
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<2, 2>(
+            edge_boxes, m_dynamic_edges, m_static_edge_boxes, m_static_edges,
+            m_static_edge_bvh, is_static_vertex, vertex_filter,
+            [](int ei, int ej) {
+                return EdgeEdgeCandidate(std::min(ei, ej), std::max(ei, ej));
+            },
+            storage);
+    });
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_face_vertex_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_face_vertex_candidates,
+        &BroadPhase::visit_face_vertex_candidates, storage,
+        [&](auto& local_candidates, const FaceVertexCandidate& c) {
+            const int vi = m_dynamic_vertices[c.vertex_id];
+            if (!is_static(vi)) {
+                local_candidates.push_back(
+                    FaceVertexCandidate(m_dynamic_faces[c.face_id], vi));
+            }
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<3, 1>(
+            face_boxes, m_dynamic_faces, m_static_vertex_boxes,
+            m_static_vertices, m_static_vertex_bvh, is_static_vertex,
+            vertex_filter,
+            [](int fi, int vi) { return FaceVertexCandidate(fi, vi); },
+            storage);
+        detect_static_candidates<1, 3>(
+            vertex_boxes, m_dynamic_vertices, m_static_face_boxes,
+            m_static_faces, m_static_face_bvh, is_static_vertex,
+            vertex_filter,
+            [](int vi, int fi) { return FaceVertexCandidate(fi, vi); },
+            storage);
+    });
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_edge_face_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_edge_face_candidates,
+        &BroadPhase::visit_edge_face_candidates, storage,
+        [&](auto& local_candidates, const EdgeFaceCandidate& c) {
+            local_candidates.push_back(EdgeFaceCandidate(
+                m_dynamic_edges[c.edge_id], m_dynamic_faces[c.face_id]));
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<2, 3>(
+            edge_boxes, m_dynamic_edges, m_static_face_boxes, m_static_faces,
+            m_static_face_bvh, is_static_vertex, vertex_filter,
+            [](int ei, int fi) { return EdgeFaceCandidate(ei, fi); },
+            storage);
+        detect_static_candidates<3, 2>(
+            face_boxes, m_dynamic_faces, m_static_edge_boxes, m_static_edges,
+            m_static_edge_bvh, is_static_vertex, vertex_filter,
+            [](int fi, int ei) { return EdgeFaceCandidate(ei, fi); },
+            storage);
+    });
+}
+
+template <typename Storage>
+void StaticDynamicSplit::find_face_face_candidates(Storage& storage) const
+{
+    find_dynamic_candidates(
+        &BroadPhase::detect_face_face_candidates,
+        &BroadPhase::visit_face_face_candidates, storage,
+        [&](auto& local_candidates, const FaceFaceCandidate& c) {
+            local_candidates.push_back(FaceFaceCandidate(
+                m_dynamic_faces[c.face0_id], m_dynamic_faces[c.face1_id]));
+        });
+
+    const auto is_static_vertex = [this](size_t vi) { return is_static(vi); };
+    dispatch_vertex_filter([&](const auto& vertex_filter) {
+        detect_static_candidates<3, 3>(
+            face_boxes, m_dynamic_faces, m_static_face_boxes, m_static_faces,
+            m_static_face_bvh, is_static_vertex, vertex_filter,
+            [](int fi, int fj) {
+                return FaceFaceCandidate(std::min(fi, fj), std::max(fi, fj));
+            },
+            storage);
+    });
+}
+
+// ============================================================================
+
+void StaticDynamicSplit::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
+}
+
+void StaticDynamicSplit::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
+}
+
+void StaticDynamicSplit::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
+}
+
+void StaticDynamicSplit::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
+}
+
+void StaticDynamicSplit::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
+}
+
+void StaticDynamicSplit::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void StaticDynamicSplit::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
+}
+
+} // namespace ipc
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/broad_phase/bvh.hpp>
+
+namespace ipc {
+
+/// @brief Broad phase that separates static geometry from dynamic geometry.
+///
+/// A primitive is static if all of its vertices are static (see
+/// BroadPhase::is_vertex_static). The static primitives are stored in BVHs that are built
+/// on the first call to build and kept until the static vertices, the number
+/// of primitives, or the inflation radius change. Pairs of dynamic primitives
+/// are found by a separate broad phase over the dynamic primitives only, and
+/// pairs of dynamic and static primitives by querying the static BVHs. Pairs of
+/// static primitives are never checked.
+///
+/// Candidates::build sets is_vertex_static from CollisionMesh::is_vertex_static.
+///
+/// @note The static vertices are assumed to not move. Call clear() if they do
+/// or if the mesh connectivity changes.
+class StaticDynamicSplit : public BroadPhase {
+public:
+    /// @brief Construct a static/dynamic split broad phase.
+    /// @param dynamic_broad_phase Broad phase used for the dynamic primitives.
+    StaticDynamicSplit(
+        std::shared_ptr<BroadPhase> dynamic_broad_phase =
+            make_broad_phase(DEFAULT_BROAD_PHASE_METHOD));
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Clear any built data (including the cached static BVHs).
+    void clear() override;
+
+    /// @brief Find the candidate vertex-vertex collisions.
+    /// @param[out] candidates The candidate vertex-vertex collisions.
+    void detect_vertex_vertex_candidates(
+        std::vector<VertexVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-vertex collisions.
+    /// @param[out] candidates The candidate edge-vertex collisions.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-face collisions.
+    /// @param[out] candidates The candidate face-face collisions.
+    void detect_face_face_candidates(
+        std::vector<FaceFaceCandidate>& candidates) const override;
+
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+    /// @brief Get the broad phase used for the dynamic primitives.
+    const std::shared_ptr<BroadPhase>& dynamic_broad_phase() const
+    {
+        return m_dynamic_broad_phase;
+    }
+
+    /// @brief Are the static BVHs built (and reused by the next build)?
+    bool is_static_built() const { return m_is_static_built; }
+
+    /// @brief Were the static BVHs rebuilt (rather than reused) by the last build?
+    bool was_static_rebuilt() const { return m_was_static_rebuilt; }
+
+protected:
+    /// @brief Partition the primitives and build the static BVHs if needed.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build_static(
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius);
+
+    /// @brief Build the edge and face boxes of the dynamic primitives from the vertex boxes.
+    void build_dynamic_boxes();
+
+    /// @brief Set the filters of the dynamic broad phase from this broad phase's filters.
+    void update_dynamic_filters();
+
+    /// @brief Add the candidates of the dynamic broad phase to a storage.
+    ///
+    /// Thread-local vectors are filled by detecting the candidates into a
+    /// vector and converting them in parallel. A CandidateVisitorStorage is
+    /// filled by streaming the candidates of the dynamic broad phase.
+    /// @tparam Candidate Type of candidate collision.
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
+    /// @param detect Dynamic broad phase's detect_*_candidates function.
+    /// @param visit Dynamic broad phase's visit_*_candidates function.
+    /// @param storage Storage the candidate collisions are added to.
+    /// @param add Function adding a dynamic candidate to the (local) storage using global ids.
+    template <typename Candidate, typename Storage, typename Add>
+    void find_dynamic_candidates(
+        void (BroadPhase::*detect)(std::vector<Candidate>&) const,
+        void (BroadPhase::*visit)(const CandidateVisitor<Candidate>&) const,
+        Storage& storage,
+        const Add& add) const;
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
+
+    /// @brief Is a vertex static?
+    bool is_static(size_t vi) const
+    {
+        return vi < is_vertex_static.size() && is_vertex_static[vi];
+    }
+
+    /// @brief Broad phase used for the dynamic primitives.
+    std::shared_ptr<BroadPhase> m_dynamic_broad_phase;
+
+    /// @brief Are the static BVHs built?
+    bool m_is_static_built = false;
+    /// @brief Were the static BVHs rebuilt by the last build?
+    bool m_was_static_rebuilt = false;
+    /// @brief Inflation radius the static BVHs were built with.
+    double m_static_inflation_radius = 0;
+    /// @brief Static vertex flags the static BVHs were built with.
+    std::vector<bool> m_built_is_vertex_static;
+    /// @brief Number of vertices the static BVHs were built with.
+    size_t m_num_vertices = 0;
+
+    /// @brief Global ids of the static vertices.
+    std::vector<int> m_static_vertices;
+    /// @brief Global ids of the static edges.
+    std::vector<int> m_static_edges;
+    /// @brief Global ids of the static faces.
+    std::vector<int> m_static_faces;
+
+    /// @brief Global ids of the vertices of the dynamic broad phase.
+    /// This includes the static vertices of dynamic edges and faces.
+    std::vector<int> m_dynamic_vertices;
+    /// @brief Global ids of the dynamic edges.
+    std::vector<int> m_dynamic_edges;
+    /// @brief Global ids of the dynamic faces.
+    std::vector<int> m_dynamic_faces;
+    /// @brief Dynamic edges indexing into m_dynamic_vertices.
+    Eigen::MatrixXi m_local_dynamic_edges;
+    /// @brief Dynamic faces indexing into m_dynamic_vertices.
+    Eigen::MatrixXi m_local_dynamic_faces;
+
+    /// @brief Boxes of the static vertices.
+    CompactAABBs m_static_vertex_boxes;
+    /// @brief Boxes of the static edges.
+    CompactAABBs m_static_edge_boxes;
+    /// @brief Boxes of the static faces.
+    CompactAABBs m_static_face_boxes;
+
+    /// @brief BVH of the static vertices.
+    BVH::Tree m_static_vertex_bvh;
+    /// @brief BVH of the static edges.
+    BVH::Tree m_static_edge_bvh;
+    /// @brief BVH of the static faces.
+    BVH::Tree m_static_face_bvh;
+
+    // The boxes of the dynamic primitives are stored in the inherited
+    // vertex_boxes, edge_boxes, and face_boxes (indexed like
+    // m_dynamic_vertices, m_dynamic_edges, and m_dynamic_faces). All boxes
+    // store global vertex ids.
+};
+
+} // namespace ipc
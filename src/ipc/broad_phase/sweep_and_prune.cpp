@@ -1,198 +1,802 @@
 #include "sweep_and_prune.hpp"
 
-#include <scalable_ccd/broad_phase/sort_and_sweep.hpp>
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/radix_sort.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 
 namespace ipc {
 
-void SweepAndPrune::build(
-    const Eigen::MatrixXd& vertices,
-    const Eigen::MatrixXi& edges,
-    const Eigen::MatrixXi& faces,
-    const double inflation_radius)
+namespace {
+    /// @brief Map a float to an unsigned integer with the same ordering.
+    uint32_t ordered_bits(const float x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(float));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    /// @brief Entry of the sorted list of boxes.
+    struct SortedBox {
+        /// @brief Ordered bits of the box's minimum along the sort axis.
+        uint32_t key;
+        /// @brief Id of the box (-(id + 1) for boxes of the second set).
+        int id;
+    };
+
+    /// @brief Pack a pair of ids into a single key.
+    uint64_t pack(const size_t id0, const size_t id1)
+    {
+        return (uint64_t(id0) << 32) | uint64_t(id1);
+    }
+
+    /// @brief Unpack keys into candidates.
+    template <typename Candidate, typename Keys>
+    void unpack(const Keys& keys, std::vector<Candidate>& candidates)
+    {
+        candidates.reserve(candidates.size() + keys.size());
+        for (const uint64_t key : keys) {
+            candidates.emplace_back(long(key >> 32), long(key & 0xFFFFFFFF));
+        }
+    }
+
+    /// @brief Replace a set of overlaps with new candidates.
+    /// @param[in] candidates The new overlapping candidates.
+    /// @param[in] ids Function returning the packed key of a candidate.
+    /// @param[in,out] overlaps The set of overlaps to replace.
+    /// @param[out] delta The candidates removed and added.
+    template <typename Candidate, typename Ids>
+    void reset_overlaps(
+        const std::vector<Candidate>& candidates,
+        Ids ids,
+        unordered_set<uint64_t>& overlaps,
+        CandidatesDelta<Candidate>& delta)
+    {
+        delta.clear();
+        unpack(overlaps, delta.removed);
+        overlaps.clear();
+        overlaps.reserve(candidates.size());
+        for (const Candidate& candidate : candidates) {
+            overlaps.insert(ids(candidate));
+        }
+        unpack(overlaps, delta.added);
+    }
+} // namespace
+
+int SweepAndPrune::choose_sort_axis(
+    const CompactAABBs& boxes0, const CompactAABBs& boxes1)
 {
-    assert(edges.size() == 0 || edges.cols() == 2);
-    assert(faces.size() == 0 || faces.cols() == 3);
+    const int dim = boxes0.dim();
+
+    // Sum and squared sum of the box centers along each axis
+    using Sums = std::array<double, 6>;
+    Sums sums {};
+    size_t n = 0;
+    for (const CompactAABBs* boxes : { &boxes0, &boxes1 }) {
+        if (boxes == &boxes1 && &boxes1 == &boxes0) {
+            break;
+        }
+
+        const Sums local_sums = tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(size_t(0), boxes->size()), Sums {},
+            [&](const tbb::blocked_range<size_t>& r, Sums s) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    for (int d = 0; d < dim; d++) {
+                        const double c =
+                            (double(boxes->min[d][i]) + boxes->max[d][i]) / 2;
+                        s[d] += c;
+                        s[3 + d] += c * c;
+                    }
+                }
+                return s;
+            },
+            [](Sums a, const Sums& b) {
+                for (size_t k = 0; k < a.size(); k++) {
+                    a[k] += b[k];
+                }
+                return a;
+            });
+
+        for (size_t k = 0; k < sums.size(); k++) {
+            sums[k] += local_sums[k];
+        }
+        n += boxes->size();
+    }
 
-    clear();
+    int axis = 0;
+    double max_variance = -1;
+    for (int d = 0; d < dim; d++) {
+        const double mean = sums[d] / n;
+        const double variance = sums[3 + d] / n - mean * mean;
+        if (variance > max_variance) {
+            max_variance = variance;
+            axis = d;
+        }
+    }
+    return axis;
+}
 
-    scalable_ccd::build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
-    scalable_ccd::build_edge_boxes(vertex_boxes, edges, edge_boxes);
-    scalable_ccd::build_face_boxes(vertex_boxes, faces, face_boxes);
+template <
+    typename Candidate,
+    bool triangular,
+    typename CanCollide,
+    typename Storage>
+void SweepAndPrune::detect_candidates(
+    const CompactAABBs& boxes0,
+    const CompactAABBs& boxes1,
+    const CanCollide& can_collide,
+    Storage& storage)
+{
+    if (boxes0.size() == 0 || boxes1.size() == 0) {
+        return;
+    }
+    assert(!triangular || &boxes0 == &boxes1);
+
+    const int axis = choose_sort_axis(boxes0, boxes1);
+
+    // 1. Sort the boxes of both sets by their minimum along the sort axis.
+    const size_t n0 = boxes0.size(), n = n0 + (triangular ? 0 : boxes1.size());
+    std::vector<SortedBox> sorted_boxes(n);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (i < n0) {
+                    sorted_boxes[i] = { ordered_bits(boxes0.min[axis][i]),
+                                        int(i) };
+                } else {
+                    sorted_boxes[i] = {
+                        ordered_bits(boxes1.min[axis][i - n0]),
+                        -int(i - n0) - 1,
+                    };
+                }
+            }
+        });
+    radix_sort(
+        sorted_boxes, [](const SortedBox& b) { return b.key; },
+        /*key_bits=*/32);
+
+    // 2. Sweep the sorted list in parallel chunks.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_candidates = storage.local();
+
+            int batch[CompactAABBs::BATCH_SIZE];
+            int batch_size = 0;
+
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const bool is_first = sorted_boxes[i].id >= 0;
+                const int id = is_first ? sorted_boxes[i].id
+                                        : (-sorted_boxes[i].id - 1);
+                const CompactAABBs& query_boxes = is_first ? boxes0 : boxes1;
+                const CompactAABBs& other_boxes = is_first ? boxes1 : boxes0;
+                const uint32_t max_key =
+                    ordered_bits(query_boxes.max[axis][id]);
+
+                // Prune the overlaps along the sort axis on all axes.
+                const auto flush_batch = [&]() {
+                    if (batch_size == 0) {
+                        return;
+                    }
+                    uint32_t overlaps = query_boxes.intersects_batch(
+                        id, other_boxes, batch, batch_size);
+                    for (int k = 0; overlaps != 0; k++, overlaps >>= 1) {
+                        if (!(overlaps & 1)) {
+                            continue;
+                        }
+
+                        const int id0 = is_first ? id : batch[k];
+                        const int id1 = is_first ? batch[k] : id;
+                        if (can_collide(id0, id1)) {
+                            local_candidates.push_back(Candidate(id0, id1));
+                        }
+                    }
+                    batch_size = 0;
+                };
+
+                for (size_t j = i + 1;
+                     j < n && sorted_boxes[j].key <= max_key; j++) {
+                    if constexpr (!triangular) {
+                        if ((sorted_boxes[j].id >= 0) == is_first) {
+                            continue; // Both boxes are from the same set
+                        }
+                    }
+
+                    batch[batch_size++] = sorted_boxes[j].id >= 0
+                        ? sorted_boxes[j].id
+                        : (-sorted_boxes[j].id - 1);
+                    if (batch_size == CompactAABBs::BATCH_SIZE) {
+                        flush_batch();
+                    }
+                }
+                flush_batch();
+            }
+        });
 }
 
-void SweepAndPrune::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
-    const Eigen::MatrixXi& edges,
-    const Eigen::MatrixXi& faces,
-    const double inflation_radius)
+template <typename Storage>
+void SweepAndPrune::find_vertex_vertex_candidates(Storage& storage) const
 {
-    assert(edges.size() == 0 || edges.cols() == 2);
-    assert(faces.size() == 0 || faces.cols() == 3);
+    dispatch_can_collide<VertexVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<VertexVertexCandidate, /*triangular=*/true>(
+            vertex_boxes, vertex_boxes, can_collide, storage);
+    });
+}
 
-    clear();
+template <typename Storage>
+void SweepAndPrune::find_edge_vertex_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeVertexCandidate>(
+            edge_boxes, vertex_boxes, can_collide, storage);
+    });
+}
 
-    scalable_ccd::build_vertex_boxes(
-        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
-    scalable_ccd::build_edge_boxes(vertex_boxes, edges, edge_boxes);
-    scalable_ccd::build_face_boxes(vertex_boxes, faces, face_boxes);
+template <typename Storage>
+void SweepAndPrune::find_edge_edge_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeEdgeCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeEdgeCandidate, /*triangular=*/true>(
+            edge_boxes, edge_boxes, can_collide, storage);
+    });
 }
 
-void SweepAndPrune::clear()
+template <typename Storage>
+void SweepAndPrune::find_face_vertex_candidates(Storage& storage) const
 {
-    BroadPhase::clear();
-    vertex_boxes.clear();
-    edge_boxes.clear();
-    face_boxes.clear();
+    dispatch_can_collide<FaceVertexCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceVertexCandidate>(
+            face_boxes, vertex_boxes, can_collide, storage);
+    });
 }
 
+template <typename Storage>
+void SweepAndPrune::find_edge_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<EdgeFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<EdgeFaceCandidate>(
+            edge_boxes, face_boxes, can_collide, storage);
+    });
+}
+
+template <typename Storage>
+void SweepAndPrune::find_face_face_candidates(Storage& storage) const
+{
+    dispatch_can_collide<FaceFaceCandidate>([&](const auto& can_collide) {
+        detect_candidates<FaceFaceCandidate, /*triangular=*/true>(
+            face_boxes, face_boxes, can_collide, storage);
+    });
+}
+
+// ============================================================================
+
 void SweepAndPrune::detect_vertex_vertex_candidates(
     std::vector<VertexVertexCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(vertex_boxes, vv_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<VertexVertexCandidate>> storage;
+    find_vertex_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
 
-    for (const auto& [vai, vbi] : overlaps) {
-        if (can_vertices_collide(vai, vbi)) {
-            candidates.emplace_back(vai, vbi);
-        }
-    }
+void SweepAndPrune::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<VertexVertexCandidate> storage { visitor };
+    find_vertex_vertex_candidates(storage);
 }
 
 void SweepAndPrune::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(
-        edge_boxes, vertex_boxes, ev_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storage;
+    find_edge_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
 
-    for (const auto& [ei, vi] : overlaps) {
-        if (can_edge_vertex_collide(ei, vi)) {
-            candidates.emplace_back(ei, vi);
-        }
-    }
+void SweepAndPrune::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeVertexCandidate> storage { visitor };
+    find_edge_vertex_candidates(storage);
 }
 
 void SweepAndPrune::detect_edge_edge_candidates(
     std::vector<EdgeEdgeCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(edge_boxes, ee_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storage;
+    find_edge_edge_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
 
-    for (const auto& [eai, ebi] : overlaps) {
-        if (can_edges_collide(eai, ebi)) {
-            candidates.emplace_back(eai, ebi);
-        }
-    }
+void SweepAndPrune::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeEdgeCandidate> storage { visitor };
+    find_edge_edge_candidates(storage);
 }
 
 void SweepAndPrune::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(
-        face_boxes, vertex_boxes, fv_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storage;
+    find_face_vertex_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
 
-    for (const auto& [fi, vi] : overlaps) {
-        if (can_face_vertex_collide(fi, vi)) {
-            candidates.emplace_back(fi, vi);
-        }
-    }
+void SweepAndPrune::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceVertexCandidate> storage { visitor };
+    find_face_vertex_candidates(storage);
 }
 
 void SweepAndPrune::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(
-        edge_boxes, face_boxes, ef_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storage;
+    find_edge_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
 
-    for (const auto& [ei, fi] : overlaps) {
-        if (can_edge_face_collide(ei, fi)) {
-            candidates.emplace_back(ei, fi);
-        }
-    }
+void SweepAndPrune::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<EdgeFaceCandidate> storage { visitor };
+    find_edge_face_candidates(storage);
 }
 
 void SweepAndPrune::detect_face_face_candidates(
     std::vector<FaceFaceCandidate>& candidates) const
 {
-    std::vector<std::pair<int, int>> overlaps;
-    scalable_ccd::sort_and_sweep(face_boxes, ff_sort_axis, overlaps);
+    tbb::enumerable_thread_specific<std::vector<FaceFaceCandidate>> storage;
+    find_face_face_candidates(storage);
+    merge_thread_local_vectors(storage, candidates);
+}
+
+void SweepAndPrune::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    CandidateVisitorStorage<FaceFaceCandidate> storage { visitor };
+    find_face_face_candidates(storage);
+}
+
+// ============================================================================
+
+void CoherentSweepAndPrune::build(
+    const Eigen::MatrixXd& vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    BroadPhase::clear(); // Keep the endpoints and overlaps
+    const auto start = std::chrono::steady_clock::now();
+    build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
+    update_overlaps(edges, faces);
+    record_boxes(start);
+}
+
+void CoherentSweepAndPrune::build(
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    assert(edges.size() == 0 || edges.cols() == 2);
+    assert(faces.size() == 0 || faces.cols() == 3);
+    BroadPhase::clear(); // Keep the endpoints and overlaps
+    const auto start = std::chrono::steady_clock::now();
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
+    update_overlaps(edges, faces);
+    record_boxes(start);
+}
+
+void CoherentSweepAndPrune::clear()
+{
+    SweepAndPrune::clear();
+    for (auto& axis_endpoints : endpoints) {
+        axis_endpoints.clear();
+    }
+    for (auto& pair_overlaps : overlaps) {
+        pair_overlaps.clear();
+    }
+    m_edges.resize(0, 0);
+    m_faces.resize(0, 0);
+    vv_delta.clear();
+    ev_delta.clear();
+    ee_delta.clear();
+    fv_delta.clear();
+    ef_delta.clear();
+    ff_delta.clear();
+    m_was_incremental = false;
+}
 
-    for (const auto& [fai, fbi] : overlaps) {
-        if (can_faces_collide(fai, fbi)) {
-            candidates.emplace_back(fai, fbi);
+void CoherentSweepAndPrune::update_overlaps(
+    const Eigen::MatrixXi& edges, const Eigen::MatrixXi& faces)
+{
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+
+    const int dim = vertex_boxes.dim();
+    const size_t num_endpoints =
+        2 * (vertex_boxes.size() + edge_boxes.size() + face_boxes.size());
+
+    // The endpoints can only be re-sorted if the mesh is the same.
+    const bool same_mesh = num_endpoints > 0
+        && endpoints[dim - 1].size() == num_endpoints
+        && (dim == 3 || endpoints[2].empty())
+        && m_edges.rows() == edges.rows() && m_edges.cols() == edges.cols()
+        && m_faces.rows() == faces.rows() && m_faces.cols() == faces.cols()
+        && m_edges == edges && m_faces == faces;
+
+    m_was_incremental = same_mesh && sort_overlaps();
+    if (!m_was_incremental) {
+        m_edges = edges;
+        m_faces = faces;
+        init_overlaps();
+    }
+}
+
+void CoherentSweepAndPrune::init_overlaps()
+{
+    const int dim = vertex_boxes.dim();
+    const size_t num_endpoints =
+        2 * (vertex_boxes.size() + edge_boxes.size() + face_boxes.size());
+
+    for (int axis = 0; axis < int(endpoints.size()); axis++) {
+        std::vector<Endpoint>& axis_endpoints = endpoints[axis];
+        if (axis >= dim) {
+            axis_endpoints.clear();
+            continue;
         }
+        axis_endpoints.resize(num_endpoints);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), num_endpoints),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    axis_endpoints[i] = endpoint(axis, uint32_t(i));
+                }
+            });
+        tbb::parallel_sort(axis_endpoints.begin(), axis_endpoints.end());
     }
+
+    // Find the initial overlaps with the parallel sweep.
+    std::vector<VertexVertexCandidate> vv;
+    SweepAndPrune::detect_vertex_vertex_candidates(vv);
+    reset_overlaps(
+        vv,
+        [](const VertexVertexCandidate& c) {
+            return pack(
+                std::min(c.vertex0_id, c.vertex1_id),
+                std::max(c.vertex0_id, c.vertex1_id));
+        },
+        overlaps[VV], vv_delta);
+
+    std::vector<EdgeVertexCandidate> ev;
+    SweepAndPrune::detect_edge_vertex_candidates(ev);
+    reset_overlaps(
+        ev,
+        [](const EdgeVertexCandidate& c) {
+            return pack(c.edge_id, c.vertex_id);
+        },
+        overlaps[EV], ev_delta);
+
+    if (dim == 2) {
+        // Only the pairs of the 2D collision candidates are kept.
+        for (const PairType type : { EE, FV, EF, FF }) {
+            assert(!is_tracked(type));
+            overlaps[type].clear();
+        }
+        ee_delta.clear();
+        fv_delta.clear();
+        ef_delta.clear();
+        ff_delta.clear();
+        return;
+    }
+
+    std::vector<EdgeEdgeCandidate> ee;
+    SweepAndPrune::detect_edge_edge_candidates(ee);
+    reset_overlaps(
+        ee,
+        [](const EdgeEdgeCandidate& c) {
+            return pack(
+                std::min(c.edge0_id, c.edge1_id),
+                std::max(c.edge0_id, c.edge1_id));
+        },
+        overlaps[EE], ee_delta);
+
+    std::vector<FaceVertexCandidate> fv;
+    SweepAndPrune::detect_face_vertex_candidates(fv);
+    reset_overlaps(
+        fv,
+        [](const FaceVertexCandidate& c) {
+            return pack(c.face_id, c.vertex_id);
+        },
+        overlaps[FV], fv_delta);
+
+    std::vector<EdgeFaceCandidate> ef;
+    SweepAndPrune::detect_edge_face_candidates(ef);
+    reset_overlaps(
+        ef,
+        [](const EdgeFaceCandidate& c) { return pack(c.edge_id, c.face_id); },
+        overlaps[EF], ef_delta);
+
+    std::vector<FaceFaceCandidate> ff;
+    SweepAndPrune::detect_face_face_candidates(ff);
+    reset_overlaps(
+        ff,
+        [](const FaceFaceCandidate& c) {
+            return pack(
+                std::min(c.face0_id, c.face1_id),
+                std::max(c.face0_id, c.face1_id));
+        },
+        overlaps[FF], ff_delta);
 }
 
-// ----------------------------------------------------------------------------
+bool CoherentSweepAndPrune::sort_overlaps()
+{
+    const int dim = vertex_boxes.dim();
+    const size_t num_endpoints = endpoints[0].size();
+    const size_t max_swaps = static_cast<size_t>(
+        std::ceil(max_swaps_per_endpoint * num_endpoints));
+
+    // 1. Insertion sort the endpoints along each axis and record the pairs
+    // whose minimum and maximum swapped (i.e., their overlap changed).
+    std::array<std::array<std::vector<uint64_t>, NUM_PAIR_TYPES>, 3> swapped;
+    std::atomic<bool> too_many_swaps(false);
+
+    tbb::parallel_for(0, dim, [&](const int axis) {
+        std::vector<Endpoint>& axis_endpoints = endpoints[axis];
+        for (Endpoint& e : axis_endpoints) {
+            e = endpoint(axis, e.code);
+        }
+
+        size_t num_swaps = 0;
+        for (size_t i = 1; i < num_endpoints; i++) {
+            const Endpoint e = axis_endpoints[i];
+            size_t j = i;
+            for (; j > 0 && e < axis_endpoints[j - 1]; j--) {
+                const Endpoint& other = axis_endpoints[j - 1];
+                if (e.is_max() != other.is_max()) {
+                    const auto [type, key] = pair_key(e.box(), other.box());
+                    if (is_tracked(type)) {
+                        swapped[axis][type].push_back(key);
+                    }
+                }
+                axis_endpoints[j] = other;
+            }
+            axis_endpoints[j] = e;
+
+            num_swaps += i - j;
+            if (num_swaps > max_swaps || too_many_swaps) {
+                too_many_swaps = true;
+                return;
+            }
+        }
+    });
+
+    if (too_many_swaps) {
+        logger().trace(
+            "too many endpoint swaps; rebuilding coherent sweep and prune");
+        return false;
+    }
 
-bool SweepAndPrune::can_edge_vertex_collide(size_t ei, size_t vi) const
+    // 2. Re-test the swapped pairs to find which overlaps changed.
+    std::array<std::vector<uint64_t>, NUM_PAIR_TYPES> added, removed;
+
+    tbb::parallel_for(0, int(NUM_PAIR_TYPES), [&](const int i) {
+        const PairType type = PairType(i);
+
+        std::vector<uint64_t> keys;
+        for (int axis = 0; axis < dim; axis++) {
+            keys.insert(
+                keys.end(), swapped[axis][type].begin(),
+                swapped[axis][type].end());
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        for (const uint64_t key : keys) {
+            const bool was_overlapping = overlaps[type].count(key) > 0;
+            const bool is_overlapping =
+                pair_overlaps(type, key >> 32, key & 0xFFFFFFFF);
+            if (is_overlapping && !was_overlapping) {
+                overlaps[type].insert(key);
+                added[type].push_back(key);
+            } else if (!is_overlapping && was_overlapping) {
+                overlaps[type].erase(key);
+                removed[type].push_back(key);
+            }
+        }
+    });
+
+    vv_delta.clear();
+    unpack(added[VV], vv_delta.added);
+    unpack(removed[VV], vv_delta.removed);
+    ev_delta.clear();
+    unpack(added[EV], ev_delta.added);
+    unpack(removed[EV], ev_delta.removed);
+    ee_delta.clear();
+    unpack(added[EE], ee_delta.added);
+    unpack(removed[EE], ee_delta.removed);
+    fv_delta.clear();
+    unpack(added[FV], fv_delta.added);
+    unpack(removed[FV], fv_delta.removed);
+    ef_delta.clear();
+    unpack(added[EF], ef_delta.added);
+    unpack(removed[EF], ef_delta.removed);
+    ff_delta.clear();
+    unpack(added[FF], ff_delta.added);
+    unpack(removed[FF], ff_delta.removed);
+
+    return true;
+}
+
+CoherentSweepAndPrune::Endpoint
+CoherentSweepAndPrune::endpoint(const int axis, const uint32_t code) const
+{
+    size_t id = code >> 1;
+    const CompactAABBs* boxes = &vertex_boxes;
+    if (id >= boxes->size()) {
+        id -= boxes->size();
+        boxes = &edge_boxes;
+        if (id >= boxes->size()) {
+            id -= boxes->size();
+            boxes = &face_boxes;
+        }
+    }
+    return { (code & 1) ? boxes->max[axis][id] : boxes->min[axis][id], code };
+}
+
+std::pair<CoherentSweepAndPrune::PairType, uint64_t>
+CoherentSweepAndPrune::pair_key(const size_t box0, const size_t box1) const
 {
-    const auto& [e0i, e1i, _] = edge_boxes[ei].vertex_ids;
+    // Split a box index into its primitive type (0: vertex, 1: edge, 2: face)
+    // and the id of the primitive.
+    const size_t num_vertices = vertex_boxes.size();
+    const size_t num_edges = edge_boxes.size();
+    const auto split = [&](const size_t box) -> std::pair<int, size_t> {
+        if (box < num_vertices) {
+            return { 0, box };
+        } else if (box < num_vertices + num_edges) {
+            return { 1, box - num_vertices };
+        }
+        return { 2, box - num_vertices - num_edges };
+    };
 
-    // Checked by scalable_ccd::sort_and_sweep
-    assert(vi != e0i && vi != e1i);
+    auto [type0, id0] = split(box0);
+    auto [type1, id1] = split(box1);
+
+    // Order the ids as in the candidates (e.g., edges before vertices).
+    if (type0 == type1 ? id0 > id1
+                       : (type0 == 0 || (type0 == 2 && type1 == 1))) {
+        std::swap(type0, type1);
+        std::swap(id0, id1);
+    }
 
-    return can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i);
+    static constexpr PairType pair_types[3][3] = {
+        { VV, EV, FV }, { EV, EE, EF }, { FV, EF, FF }
+    };
+    return { pair_types[type0][type1], pack(id0, id1) };
 }
 
-bool SweepAndPrune::can_edges_collide(size_t eai, size_t ebi) const
+bool CoherentSweepAndPrune::pair_overlaps(
+    const PairType type, const size_t id0, const size_t id1) const
 {
-    const auto& [ea0i, ea1i, _] = edge_boxes[eai].vertex_ids;
-    const auto& [eb0i, eb1i, __] = edge_boxes[ebi].vertex_ids;
+    switch (type) {
+    case VV:
+        return vertex_boxes.intersects(id0, vertex_boxes, id1)
+            && can_vertex_pair_collide(id0, id1);
+    case EV:
+        return edge_boxes.intersects(id0, vertex_boxes, id1)
+            && can_edge_vertex_collide(id0, id1);
+    case EE:
+        return edge_boxes.intersects(id0, edge_boxes, id1)
+            && can_edges_collide(id0, id1);
+    case FV:
+        return face_boxes.intersects(id0, vertex_boxes, id1)
+            && can_face_vertex_collide(id0, id1);
+    case EF:
+        return edge_boxes.intersects(id0, face_boxes, id1)
+            && can_edge_face_collide(id0, id1);
+    case FF:
+        return face_boxes.intersects(id0, face_boxes, id1)
+            && can_faces_collide(id0, id1);
+    default:
+        assert(false);
+        return false;
+    }
+}
 
-    // Checked by scalable_ccd::sort_and_sweep
-    assert(ea0i != eb0i && ea0i != eb1i && ea1i != eb0i && ea1i != eb1i);
+void CoherentSweepAndPrune::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    unpack(overlaps[VV], candidates);
+}
 
-    return can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
-        || can_vertices_collide(ea1i, eb0i) || can_vertices_collide(ea1i, eb1i);
+void CoherentSweepAndPrune::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    unpack(overlaps[EV], candidates);
 }
 
-bool SweepAndPrune::can_face_vertex_collide(size_t fi, size_t vi) const
+void CoherentSweepAndPrune::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
 {
-    const auto& [f0i, f1i, f2i] = face_boxes[fi].vertex_ids;
+    if (!is_tracked(EE)) {
+        SweepAndPrune::detect_edge_edge_candidates(candidates);
+        return;
+    }
+    unpack(overlaps[EE], candidates);
+}
 
-    // Checked by scalable_ccd::sort_and_sweep
-    assert(vi != f0i && vi != f1i && vi != f2i);
+void CoherentSweepAndPrune::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    unpack(overlaps[FV], candidates);
+}
 
-    return can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
-        || can_vertices_collide(vi, f2i);
+void CoherentSweepAndPrune::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    unpack(overlaps[EF], candidates);
+}
+
+void CoherentSweepAndPrune::detect_face_face_candidates(
+    std::vector<FaceFaceCandidate>& candidates) const
+{
+    unpack(overlaps[FF], candidates);
 }
 
-bool SweepAndPrune::can_edge_face_collide(size_t ei, size_t fi) const
+void CoherentSweepAndPrune::visit_vertex_vertex_candidates(
+    const CandidateVisitor<VertexVertexCandidate>& visitor) const
 {
-    const auto& [e0i, e1i, _] = edge_boxes[ei].vertex_ids;
-    const auto& [f0i, f1i, f2i] = face_boxes[fi].vertex_ids;
+    BroadPhase::visit_vertex_vertex_candidates(visitor);
+}
 
-    // Checked by scalable_ccd::sort_and_sweep
-    assert(
-        e0i != f0i && e0i != f1i && e0i != f2i && e1i != f0i && e1i != f1i
-        && e1i != f2i);
+void CoherentSweepAndPrune::visit_edge_vertex_candidates(
+    const CandidateVisitor<EdgeVertexCandidate>& visitor) const
+{
+    BroadPhase::visit_edge_vertex_candidates(visitor);
+}
 
-    return can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
-        || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
-        || can_vertices_collide(e1i, f1i) || can_vertices_collide(e1i, f2i);
+void CoherentSweepAndPrune::visit_edge_edge_candidates(
+    const CandidateVisitor<EdgeEdgeCandidate>& visitor) const
+{
+    BroadPhase::visit_edge_edge_candidates(visitor);
 }
 
-bool SweepAndPrune::can_faces_collide(size_t fai, size_t fbi) const
+void CoherentSweepAndPrune::visit_face_vertex_candidates(
+    const CandidateVisitor<FaceVertexCandidate>& visitor) const
 {
-    const auto& [fa0i, fa1i, fa2i] = face_boxes[fai].vertex_ids;
-    const auto& [fb0i, fb1i, fb2i] = face_boxes[fbi].vertex_ids;
+    BroadPhase::visit_face_vertex_candidates(visitor);
+}
 
-    // Checked by scalable_ccd::sort_and_sweep
-    assert(
-        fa0i != fb0i && fa0i != fb1i && fa0i != fb2i && fa1i != fb0i
-        && fa1i != fb1i && fa1i != fb2i && fa2i != fb0i && fa2i != fb1i
-        && fa2i != fb2i);
+void CoherentSweepAndPrune::visit_edge_face_candidates(
+    const CandidateVisitor<EdgeFaceCandidate>& visitor) const
+{
+    BroadPhase::visit_edge_face_candidates(visitor);
+}
 
-    return can_vertices_collide(fa0i, fb0i) || can_vertices_collide(fa0i, fb1i)
-        || can_vertices_collide(fa0i, fb2i) || can_vertices_collide(fa1i, fb0i)
-        || can_vertices_collide(fa1i, fb1i) || can_vertices_collide(fa1i, fb2i)
-        || can_vertices_collide(fa2i, fb0i) || can_vertices_collide(fa2i, fb1i)
-        || can_vertices_collide(fa2i, fb2i);
+void CoherentSweepAndPrune::visit_face_face_candidates(
+    const CandidateVisitor<FaceFaceCandidate>& visitor) const
+{
+    BroadPhase::visit_face_face_candidates(visitor);
 }
 
-} // namespace ipc
\ No newline at end of file
+} // namespace ipc
@@ -1,15 +1,157 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/unordered_map_and_set.hpp>
 
-#include <scalable_ccd/broad_phase/aabb.hpp>
+#include <array>
 
 namespace ipc {
 
+/// @brief Parallel sweep and prune broad phase.
+///
+/// The boxes are sorted along the axis with the largest variance of their
+/// centers and the sorted list is swept in parallel chunks. Overlaps along the
+/// sort axis are pruned on the remaining axes with batched box tests.
 class SweepAndPrune : public BroadPhase {
 public:
     SweepAndPrune() = default;
 
+    /// @brief Find the candidate vertex-vertex collisions.
+    /// @param[out] candidates The candidate vertex-vertex collisions.
+    void detect_vertex_vertex_candidates(
+        std::vector<VertexVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-vertex collisions.
+    /// @param[out] candidates The candidate edge-vertex collisions.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-face collisions.
+    /// @param[out] candidates The candidate face-face collisions.
+    void detect_face_face_candidates(
+        std::vector<FaceFaceCandidate>& candidates) const override;
+
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+protected:
+    /// @brief Choose the axis along which the box centers vary the most.
+    /// @param boxes0 First set of boxes.
+    /// @param boxes1 Second set of boxes (may be the same as the first).
+    /// @return The index of the sort axis.
+    static int
+    choose_sort_axis(const CompactAABBs& boxes0, const CompactAABBs& boxes1);
+
+    /// @brief Detect candidate collisions between two sets of boxes.
+    /// @tparam Candidate Type of candidate collision.
+    /// @tparam triangular Whether the two sets are the same and (i, j) and (j, i) are the same.
+    /// @tparam Storage Thread-local candidate vectors or a CandidateVisitorStorage.
+    /// @param[in] boxes0 First set of boxes.
+    /// @param[in] boxes1 Second set of boxes.
+    /// @param[in] can_collide Function to determine if two primitives can collide given their ids.
+    /// @param[out] storage Storage the candidate collisions are added to.
+    template <
+        typename Candidate,
+        bool triangular = false,
+        typename CanCollide,
+        typename Storage>
+    static void detect_candidates(
+        const CompactAABBs& boxes0,
+        const CompactAABBs& boxes1,
+        const CanCollide& can_collide,
+        Storage& storage);
+
+    // The following find the candidates of each type and add them to
+    // thread-local vectors (detect_*) or a CandidateVisitorStorage (visit_*).
+
+    template <typename Storage>
+    void find_vertex_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_edge_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_vertex_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_edge_face_candidates(Storage& storage) const;
+    template <typename Storage>
+    void find_face_face_candidates(Storage& storage) const;
+};
+
+/// @brief Candidates added and removed since the previous build.
+template <typename Candidate> struct CandidatesDelta {
+    /// @brief Candidates that started overlapping.
+    std::vector<Candidate> added;
+    /// @brief Candidates that stopped overlapping.
+    std::vector<Candidate> removed;
+
+    void clear()
+    {
+        added.clear();
+        removed.clear();
+    }
+};
+
+/// @brief Sweep and prune exploiting the temporal coherence between builds.
+///
+/// The sorted endpoints along each axis and the set of overlapping boxes are
+/// kept from the previous build. Rebuilding the same mesh re-sorts the
+/// endpoints with an insertion sort, and only the pairs whose endpoints swapped
+/// are re-tested. This is nearly linear for small displacements, and the pairs
+/// that were added or removed are reported as deltas.
+///
+/// In 2D, only the vertex-vertex and edge-vertex overlaps are kept (the only
+/// pairs of the 2D collision candidates), and the edge-edge candidates are
+/// found with a full sweep.
+///
+/// @note The filters are applied when a pair is re-tested, so they must not
+/// change between builds. Call clear() if they do.
+class CoherentSweepAndPrune : public SweepAndPrune {
+public:
+    CoherentSweepAndPrune() = default;
+
     /// @brief Build the broad phase for static collision detection.
     /// @param vertices Vertex positions
     /// @param edges Collision mesh edges
@@ -19,11 +161,11 @@ public:
         const Eigen::MatrixXd& vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
-        double inflation_radius = 0) override;
+        const double inflation_radius = 0) override;
 
     /// @brief Build the broad phase for continuous collision detection.
-    /// @param vertices_t0 Starting vertex positions
-    /// @param vertices_t1 Ending vertex positions
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
     /// @param edges Collision mesh edges
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
@@ -32,7 +174,7 @@ public:
         const Eigen::MatrixXd& vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
-        double inflation_radius = 0) override;
+        const double inflation_radius = 0) override;
 
     /// @brief Clear any built data.
     void clear() override;
@@ -67,23 +209,147 @@ public:
     void detect_face_face_candidates(
         std::vector<FaceFaceCandidate>& candidates) const override;
 
+    /// @brief Stream the candidate vertex-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate vertex-vertex collision.
+    void visit_vertex_vertex_candidates(
+        const CandidateVisitor<VertexVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-vertex collision.
+    void visit_edge_vertex_candidates(
+        const CandidateVisitor<EdgeVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-edge collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-edge collision.
+    void visit_edge_edge_candidates(
+        const CandidateVisitor<EdgeEdgeCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-vertex collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-vertex collision.
+    void visit_face_vertex_candidates(
+        const CandidateVisitor<FaceVertexCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate edge-face intersections to a visitor without storing them.
+    /// @param visitor Function called on each candidate edge-face intersection.
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override;
+
+    /// @brief Stream the candidate face-face collisions to a visitor without storing them.
+    /// @param visitor Function called on each candidate face-face collision.
+    void visit_face_face_candidates(
+        const CandidateVisitor<FaceFaceCandidate>& visitor) const override;
+
+    /// @brief Vertex-vertex candidates added and removed by the last build.
+    const CandidatesDelta<VertexVertexCandidate>& vertex_vertex_delta() const
+    {
+        return vv_delta;
+    }
+
+    /// @brief Edge-vertex candidates added and removed by the last build.
+    const CandidatesDelta<EdgeVertexCandidate>& edge_vertex_delta() const
+    {
+        return ev_delta;
+    }
+
+    /// @brief Edge-edge candidates added and removed by the last build.
+    const CandidatesDelta<EdgeEdgeCandidate>& edge_edge_delta() const
+    {
+        return ee_delta;
+    }
+
+    /// @brief Face-vertex candidates added and removed by the last build.
+    const CandidatesDelta<FaceVertexCandidate>& face_vertex_delta() const
+    {
+        return fv_delta;
+    }
+
+    /// @brief Edge-face candidates added and removed by the last build.
+    const CandidatesDelta<EdgeFaceCandidate>& edge_face_delta() const
+    {
+        return ef_delta;
+    }
+
+    /// @brief Face-face candidates added and removed by the last build.
+    const CandidatesDelta<FaceFaceCandidate>& face_face_delta() const
+    {
+        return ff_delta;
+    }
+
+    /// @brief Whether the last build updated the previous one incrementally.
+    bool was_incremental() const { return m_was_incremental; }
+
+    /// @brief Maximum number of endpoint swaps per endpoint before falling back to a full build.
+    double max_swaps_per_endpoint = 16;
+
 protected:
-    bool can_edge_vertex_collide(size_t ei, size_t vi) const override;
-    bool can_edges_collide(size_t eai, size_t ebi) const override;
-    bool can_face_vertex_collide(size_t fi, size_t vi) const override;
-    bool can_edge_face_collide(size_t ei, size_t fi) const override;
-    bool can_faces_collide(size_t fai, size_t fbi) const override;
-
-    std::vector<scalable_ccd::AABB> vertex_boxes;
-    std::vector<scalable_ccd::AABB> edge_boxes;
-    std::vector<scalable_ccd::AABB> face_boxes;
-
-    mutable int vv_sort_axis = 0;
-    mutable int ev_sort_axis = 0;
-    mutable int ee_sort_axis = 0;
-    mutable int fv_sort_axis = 0;
-    mutable int ef_sort_axis = 0;
-    mutable int ff_sort_axis = 0;
+    /// @brief Types of overlapping pairs of primitives.
+    enum PairType { VV, EV, EE, FV, EF, FF, NUM_PAIR_TYPES };
+
+    /// @brief Endpoint of a box along an axis.
+    struct Endpoint {
+        /// @brief Coordinate of the endpoint.
+        float value;
+        /// @brief Twice the index of the box (over the vertex, edge, and face boxes) plus one for maximum endpoints.
+        uint32_t code;
+
+        size_t box() const { return code >> 1; }
+        bool is_max() const { return code & 1; }
+
+        /// @brief Order by coordinate with minimums before maximums on ties.
+        bool operator<(const Endpoint& other) const
+        {
+            return value < other.value
+                || (value == other.value && is_max() < other.is_max());
+        }
+    };
+
+    /// @brief Finish building once the vertex boxes are computed.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    void update_overlaps(
+        const Eigen::MatrixXi& edges, const Eigen::MatrixXi& faces);
+
+    /// @brief Sort the endpoints and find all overlaps from scratch.
+    void init_overlaps();
+
+    /// @brief Re-sort the endpoints with insertion sort and update the overlaps of swapped pairs.
+    /// @return False if the endpoints moved too much and nothing was updated.
+    bool sort_overlaps();
+
+    /// @brief Get the endpoint of a box along an axis.
+    Endpoint endpoint(int axis, uint32_t code) const;
+
+    /// @brief Get the type of pair and its packed ids for two boxes.
+    std::pair<PairType, uint64_t> pair_key(size_t box0, size_t box1) const;
+
+    /// @brief Check if a pair of primitives currently overlaps and can collide.
+    bool pair_overlaps(PairType type, size_t id0, size_t id1) const;
+
+    /// @brief Are the overlaps of a type of pair kept between builds?
+    bool is_tracked(PairType type) const
+    {
+        return vertex_boxes.dim() == 3 || type == VV || type == EV;
+    }
+
+    /// @brief Sorted endpoints of the boxes along each axis.
+    std::array<std::vector<Endpoint>, 3> endpoints;
+
+    /// @brief Packed ids of the overlapping pairs of each type.
+    std::array<unordered_set<uint64_t>, NUM_PAIR_TYPES> overlaps;
+
+    /// @brief Edges of the last build used to detect changes to the mesh.
+    Eigen::MatrixXi m_edges;
+    /// @brief Faces of the last build used to detect changes to the mesh.
+    Eigen::MatrixXi m_faces;
+
+    CandidatesDelta<VertexVertexCandidate> vv_delta;
+    CandidatesDelta<EdgeVertexCandidate> ev_delta;
+    CandidatesDelta<EdgeEdgeCandidate> ee_delta;
+    CandidatesDelta<FaceVertexCandidate> fv_delta;
+    CandidatesDelta<EdgeFaceCandidate> ef_delta;
+    CandidatesDelta<FaceFaceCandidate> ff_delta;
+
+    bool m_was_incremental = false;
 };
 
-} // namespace ipc
\ No newline at end of file
+} // namespace ipc
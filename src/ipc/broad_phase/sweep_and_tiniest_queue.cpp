@@ -83,7 +83,7 @@ void SweepAndTiniestQueue::detect_vertex_vertex_candidates(
         std::make_shared<scalable_ccd::cuda::DeviceAABBs>(vertex_boxes));
 
     for (const auto& [vai, vbi] : broad_phase.detect_overlaps()) {
-        if (can_vertices_collide(vai, vbi)) {
+        if (can_vertex_pair_collide(vai, vbi)) {
             candidates.emplace_back(vai, vbi);
         }
     }
@@ -176,7 +176,8 @@ bool SweepAndTiniestQueue::can_edge_vertex_collide(size_t ei, size_t vi) const
     // Checked by scalable_ccd
     assert(vi != e0i && vi != e1i);
 
-    return can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i);
+    return can_vertex_pair_collide(vi, e0i)
+        || can_vertex_pair_collide(vi, e1i);
 }
 
 bool SweepAndTiniestQueue::can_edges_collide(size_t eai, size_t ebi) const
@@ -187,8 +188,10 @@ bool SweepAndTiniestQueue::can_edges_collide(size_t eai, size_t ebi) const
     // Checked by scalable_ccd
     assert(ea0i != eb0i && ea0i != eb1i && ea1i != eb0i && ea1i != eb1i);
 
-    return can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
-        || can_vertices_collide(ea1i, eb0i) || can_vertices_collide(ea1i, eb1i);
+    return can_vertex_pair_collide(ea0i, eb0i)
+        || can_vertex_pair_collide(ea0i, eb1i)
+        || can_vertex_pair_collide(ea1i, eb0i)
+        || can_vertex_pair_collide(ea1i, eb1i);
 }
 
 bool SweepAndTiniestQueue::can_face_vertex_collide(size_t fi, size_t vi) const
@@ -198,8 +201,9 @@ bool SweepAndTiniestQueue::can_face_vertex_collide(size_t fi, size_t vi) const
     // Checked by scalable_ccd
     assert(vi != f0i && vi != f1i && vi != f2i);
 
-    return can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
-        || can_vertices_collide(vi, f2i);
+    return can_vertex_pair_collide(vi, f0i)
+        || can_vertex_pair_collide(vi, f1i)
+        || can_vertex_pair_collide(vi, f2i);
 }
 
 bool SweepAndTiniestQueue::can_edge_face_collide(size_t ei, size_t fi) const
@@ -212,9 +216,12 @@ bool SweepAndTiniestQueue::can_edge_face_collide(size_t ei, size_t fi) const
         e0i != f0i && e0i != f1i && e0i != f2i && e1i != f0i && e1i != f1i
         && e1i != f2i);
 
-    return can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
-        || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
-        || can_vertices_collide(e1i, f1i) || can_vertices_collide(e1i, f2i);
+    return can_vertex_pair_collide(e0i, f0i)
+        || can_vertex_pair_collide(e0i, f1i)
+        || can_vertex_pair_collide(e0i, f2i)
+        || can_vertex_pair_collide(e1i, f0i)
+        || can_vertex_pair_collide(e1i, f1i)
+        || can_vertex_pair_collide(e1i, f2i);
 }
 
 bool SweepAndTiniestQueue::can_faces_collide(size_t fai, size_t fbi) const
@@ -228,11 +235,15 @@ bool SweepAndTiniestQueue::can_faces_collide(size_t fai, size_t fbi) const
         && fa1i != fb1i && fa1i != fb2i && fa2i != fb0i && fa2i != fb1i
         && fa2i != fb2i);
 
-    return can_vertices_collide(fa0i, fb0i) || can_vertices_collide(fa0i, fb1i)
-        || can_vertices_collide(fa0i, fb2i) || can_vertices_collide(fa1i, fb0i)
-        || can_vertices_collide(fa1i, fb1i) || can_vertices_collide(fa1i, fb2i)
-        || can_vertices_collide(fa2i, fb0i) || can_vertices_collide(fa2i, fb1i)
-        || can_vertices_collide(fa2i, fb2i);
+    return can_vertex_pair_collide(fa0i, fb0i)
+        || can_vertex_pair_collide(fa0i, fb1i)
+        || can_vertex_pair_collide(fa0i, fb2i)
+        || can_vertex_pair_collide(fa1i, fb0i)
+        || can_vertex_pair_collide(fa1i, fb1i)
+        || can_vertex_pair_collide(fa1i, fb2i)
+        || can_vertex_pair_collide(fa2i, fb0i)
+        || can_vertex_pair_collide(fa2i, fb1i)
+        || can_vertex_pair_collide(fa2i, fb2i);
 }
 
 } // namespace ipc
@@ -1,185 +1,485 @@
 #include "candidates.hpp"
 
 #include <ipc/ipc.hpp>
+#include <ipc/broad_phase/broad_phase_filter_guard.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/save_obj.hpp>
 
 #include <ipc/config.hpp>
 
-#include <igl/remove_unreferenced.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_group.h>
 #include <tbb/blocked_range.h>
-#include <shared_mutex>
+#include <tbb/enumerable_thread_specific.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <functional>
 
 namespace ipc {
 
 namespace {
-    // Pad codim_edges because remove_unreferenced requires a N×3 matrix.
-    Eigen::MatrixXi pad_edges(const Eigen::MatrixXi& E)
+    /// @brief Number of candidates between refreshes of a thread's cached
+    /// copy of the earliest time of impact.
+    constexpr size_t TMAX_REFRESH_INTERVAL = 16;
+
+    /// @brief Atomically lower a value to the minimum of itself and x.
+    void atomic_min(std::atomic<double>& value, const double x)
     {
-        assert(E.cols() == 2);
-        Eigen::MatrixXi E_padded(E.rows(), 3);
-        E_padded.leftCols(2) = E;
-        E_padded.col(2) = E.col(1);
-        return E_padded;
+        double current = value.load(std::memory_order_relaxed);
+        // On failure, current is updated to the latest value.
+        while (x < current
+               && !value.compare_exchange_weak(
+                   current, x, std::memory_order_relaxed)) { }
     }
 
-    Eigen::MatrixXi unpad_edges(const Eigen::MatrixXi& E_padded)
+    /// @brief Conservative pre-pass of the narrow phase CCD.
+    ///
+    /// Computes a cheap lower bound on the time of impact reported by the
+    /// narrow phase for every candidate and discards the candidates that
+    /// cannot report a collision before tmax.
+    /// @param candidates The candidates to filter.
+    /// @param mesh The collision mesh.
+    /// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+    /// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+    /// @param min_distance The minimum distance allowable between any two elements.
+    /// @param tmax Maximum time (normalized) to look for collisions.
+    /// @return Pairs of the lower bound and candidate index (in no particular order).
+    std::vector<std::pair<double, size_t>> filter_candidates_by_toi_lower_bound(
+        const Candidates& candidates,
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double min_distance,
+        const double tmax = 1.0)
     {
-        return E_padded.leftCols(2);
+        tbb::enumerable_thread_specific<std::vector<std::pair<double, size_t>>>
+            storage;
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_filtered_candidates = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const ContinuousCollisionCandidate& candidate =
+                        candidates[i];
+                    // The narrow phase stops short of the impact by at most
+                    // the conservative rescaling, so scale the bound to also
+                    // bound its output.
+                    const double toi_lower_bound =
+                        DEFAULT_CCD_CONSERVATIVE_RESCALING
+                        * candidate.toi_lower_bound(
+                            candidate.dof(
+                                vertices_t0, mesh.edges(), mesh.faces()),
+                            candidate.dof(
+                                vertices_t1, mesh.edges(), mesh.faces()),
+                            min_distance);
+                    if (toi_lower_bound < tmax) {
+                        local_filtered_candidates.emplace_back(
+                            toi_lower_bound, i);
+                    }
+                }
+            });
+
+        std::vector<std::pair<double, size_t>> filtered_candidates;
+        merge_thread_local_vectors(storage, filtered_candidates);
+        return filtered_candidates;
     }
-} // namespace
 
-void Candidates::build(
-    const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
-    const double inflation_radius,
-    const BroadPhaseMethod broad_phase_method)
-{
-    const int dim = vertices.cols();
+    using CandidateFilter = std::function<bool(const CollisionStencil&)>;
 
-    clear();
+    /// @brief Filter applied to the candidates as the broad phase streams them.
+    /// Counts the rejected candidates so the profile still sees all of them.
+    class StreamFilter {
+    public:
+        /// @param filter Function returning true for the candidates to keep (empty to keep all).
+        explicit StreamFilter(const CandidateFilter& filter)
+            : m_filter(filter), m_num_rejected(size_t(0))
+        {
+        }
 
-    std::shared_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(vertices, mesh.edges(), mesh.faces(), inflation_radius);
-    broad_phase->detect_collision_candidates(dim, *this);
-
-    // Codim. vertices to codim. vertices:
-    if (mesh.num_codim_vertices()) {
-        broad_phase->clear();
-        broad_phase->build(
-            vertices(mesh.codim_vertices(), Eigen::all), //
-            Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
-
-        broad_phase->detect_vertex_vertex_candidates(vv_candidates);
-        for (auto& [vi, vj] : vv_candidates) {
-            vi = mesh.codim_vertices()[vi];
-            vj = mesh.codim_vertices()[vj];
+        /// @brief Check if a candidate is kept, counting it if it is not.
+        bool operator()(const CollisionStencil& candidate) const
+        {
+            if (!m_filter || m_filter(candidate)) {
+                return true;
+            }
+            ++m_num_rejected.local();
+            return false;
         }
-    }
 
-    // Codim. edges to codim. vertices:
-    // Only need this in 3D because in 2D, the codim. edges are the same as the
-    // edges of the boundary. Only need codim. edge to codim. vertex because
-    // codim. edge to non-codim. vertex is the same as edge-edge or face-vertex.
-    if (dim == 3 && mesh.num_codim_vertices() && mesh.num_codim_edges()) {
-        // Extract the vertices of the codim. edges
-        Eigen::MatrixXd CE_V; // vertices of codim. edges
-        Eigen::MatrixXi CE;   // codim. edges (indices into CEV)
+        /// @brief Number of candidates rejected so far.
+        size_t num_rejected() const
         {
-            Eigen::VectorXi _I, _J; // unused mappings
-            igl::remove_unreferenced(
-                vertices,
-                pad_edges(mesh.edges()(mesh.codim_edges(), Eigen::all)), CE_V,
-                CE, _I, _J);
-            CE = unpad_edges(CE);
+            return m_num_rejected.combine(std::plus<size_t>());
         }
 
-        const size_t nCV = mesh.num_codim_vertices();
-        Eigen::MatrixXd V(nCV + CE_V.rows(), dim);
-        V.topRows(nCV) = vertices(mesh.codim_vertices(), Eigen::all);
-        V.bottomRows(CE_V.rows()) = CE_V;
+    private:
+        const CandidateFilter& m_filter;
+        mutable tbb::enumerable_thread_specific<size_t> m_num_rejected;
+    };
+
+    /// @brief Collect the candidates streamed by a broad phase that pass a filter.
+    /// @param visit Function streaming the candidates to a visitor.
+    /// @param keep Filter applied to each candidate.
+    /// @param candidates The candidates to append to.
+    template <typename Candidate, typename Visit>
+    void collect_candidates(
+        const Visit& visit,
+        const StreamFilter& keep,
+        std::vector<Candidate>& candidates)
+    {
+        collect_thread_local_vectors<Candidate>(
+            [&](const auto& emit) {
+                visit([&](const Candidate& candidate) {
+                    if (keep(candidate)) {
+                        emit(candidate);
+                    }
+                });
+            },
+            candidates);
+    }
+
+    /// @brief Set the filters of a broad phase from a collision mesh.
+    /// @param mesh The collision mesh.
+    /// @param broad_phase The broad phase to set the filters of.
+    void set_mesh_filters(const CollisionMesh& mesh, BroadPhase& broad_phase)
+    {
+        broad_phase.can_vertices_collide = mesh.can_collide;
+        broad_phase.collision_groups = mesh.collision_groups;
+        broad_phase.is_vertex_static = mesh.is_vertex_static;
+    }
+
+    /// @brief Find the codim. edge to codim. vertex candidates.
+    /// @param mesh The collision mesh.
+    /// @param broad_phase Broad phase built over the full collision mesh.
+    /// @param keep Filter applied to each candidate.
+    /// @param ev_candidates The candidates to append to.
+    void detect_codim_edge_vertex_candidates(
+        const CollisionMesh& mesh,
+        BroadPhase& broad_phase,
+        const StreamFilter& keep,
+        std::vector<EdgeVertexCandidate>& ev_candidates)
+    {
+        std::vector<bool> is_codim_vertex(mesh.num_vertices(), false);
+        for (const int vi : mesh.codim_vertices()) {
+            is_codim_vertex[vi] = true;
+        }
+        std::vector<bool> is_codim_edge(mesh.num_edges(), false);
+        for (const int ei : mesh.codim_edges()) {
+            is_codim_edge[ei] = true;
+        }
 
-        CE.array() += nCV; // Offset indices to account for codim. vertices
+        // The caller's filters are restored on return.
+        const BroadPhaseFilterGuard filter_guard(broad_phase);
 
-        // TODO: Can we reuse the broad phase from above?
-        broad_phase->clear();
-        broad_phase->can_vertices_collide = [&](size_t vi, size_t vj) {
-            // Ignore c-edge to c-edge and c-vertex to c-vertex
-            return ((vi < nCV) ^ (vj < nCV)) && mesh.can_collide(vi, vj);
+        // The vertices of an edge are never codim. vertices, so this only
+        // keeps the codim. vertices when testing an edge against a vertex.
+        broad_phase.can_vertices_collide = [&](size_t vi, size_t vj) {
+            return (is_codim_vertex[vi] || is_codim_vertex[vj])
+                && mesh.can_collide(vi, vj);
         };
-        broad_phase->build(V, CE, Eigen::MatrixXi(), inflation_radius);
 
-        broad_phase->detect_edge_vertex_candidates(ev_candidates);
-        for (auto& [ei, vi] : ev_candidates) {
-            assert(vi < mesh.codim_vertices().size());
-            ei = mesh.codim_edges()[ei];    // Map back to mesh.edges
-            vi = mesh.codim_vertices()[vi]; // Map back to vertices
-        }
+        collect_thread_local_vectors<EdgeVertexCandidate>(
+            [&](const auto& emit) {
+                broad_phase.visit_edge_vertex_candidates(
+                    [&](const EdgeVertexCandidate& candidate) {
+                        // Broad phases that wrap another broad phase only
+                        // forward their filter when built, so check both.
+                        if (is_codim_edge[candidate.edge_id]
+                            && is_codim_vertex[candidate.vertex_id]
+                            && keep(candidate)) {
+                            emit(candidate);
+                        }
+                    });
+            },
+            ev_candidates);
     }
-}
 
-void Candidates::build(
-    const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
-    const double inflation_radius,
-    const BroadPhaseMethod broad_phase_method)
-{
-    const int dim = vertices_t0.cols();
+    /// @brief Find the codim. vertex to codim. vertex candidates.
+    /// @param mesh The collision mesh.
+    /// @param broad_phase Broad phase to build over the codim. vertices.
+    /// @param build Function building a broad phase over the codim. vertices.
+    /// @param keep Filter applied to each candidate.
+    /// @param vv_candidates The candidates to fill.
+    template <typename Build>
+    void detect_codim_vertex_vertex_candidates(
+        const CollisionMesh& mesh,
+        BroadPhase& broad_phase,
+        const Build& build,
+        const StreamFilter& keep,
+        std::vector<VertexVertexCandidate>& vv_candidates)
+    {
+        const Eigen::VectorXi& codim_vertices = mesh.codim_vertices();
 
-    clear();
+        // The broad phase uses local ids, so map them to the mesh's ids.
+        broad_phase.can_vertices_collide = [&](size_t vi, size_t vj) {
+            return mesh.can_collide(codim_vertices[vi], codim_vertices[vj]);
+        };
+        broad_phase.collision_groups =
+            mesh.collision_groups.select(codim_vertices);
+        // Treating every codim. vertex as dynamic is always conservative.
+        broad_phase.is_vertex_static.clear();
+        build(broad_phase);
 
-    std::shared_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(
-        vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), inflation_radius);
-    broad_phase->detect_collision_candidates(dim, *this);
-
-    // Codim. vertices to codim. vertices:
-    if (mesh.num_codim_vertices()) {
-        broad_phase->clear();
-        broad_phase->build(
-            vertices_t0(mesh.codim_vertices(), Eigen::all),
-            vertices_t1(mesh.codim_vertices(), Eigen::all), //
-            Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
-
-        broad_phase->detect_vertex_vertex_candidates(vv_candidates);
+        broad_phase.detect_vertex_vertex_candidates(vv_candidates);
         for (auto& [vi, vj] : vv_candidates) {
-            vi = mesh.codim_vertices()[vi];
-            vj = mesh.codim_vertices()[vj];
+            vi = codim_vertices[vi];
+            vj = codim_vertices[vj];
         }
+
+        // The filter sees the mesh's ids, so it is applied after mapping them.
+        vv_candidates.erase(
+            std::remove_if(
+                vv_candidates.begin(), vv_candidates.end(),
+                [&](const VertexVertexCandidate& candidate) {
+                    return !keep(candidate);
+                }),
+            vv_candidates.end());
     }
 
-    // Codim. edges to codim. vertices:
-    // Only need this in 3D because in 2D, the codim. edges are the same as the
-    // edges of the boundary. Only need codim. edge to codim. vertex because
-    // codim. edge to non-codim. vertex is the same as edge-edge or face-vertex.
-    if (dim == 3 && mesh.num_codim_vertices() && mesh.num_codim_edges()) {
-        // Extract the vertices of the codim. edges
-        Eigen::MatrixXd CE_V_t0, CE_V_t1; // vertices of codim. edges
-        Eigen::MatrixXi CE;               // codim. edges (indices into CEV)
-        {
-            Eigen::VectorXi _I, J;
-            igl::remove_unreferenced(
-                vertices_t0,
-                pad_edges(mesh.edges()(mesh.codim_edges(), Eigen::all)),
-                CE_V_t0, CE, _I, J);
-            CE_V_t1 = vertices_t1(J, Eigen::all);
-            CE = unpad_edges(CE);
+    /// @brief Build the candidates of a collision mesh.
+    /// @param mesh The collision mesh.
+    /// @param dim Dimension of the vertices.
+    /// @param broad_phase Broad phase to build over the full collision mesh.
+    /// @param codim_broad_phase Broad phase to build over the codim. vertices (may be broad_phase).
+    /// @param build Function building a broad phase over the full collision mesh.
+    /// @param build_codim Function building a broad phase over the codim. vertices.
+    /// @param filter Function returning true for the candidates to keep (empty to keep all).
+    /// @param candidates The candidates to fill.
+    template <typename Build, typename BuildCodim>
+    void build_candidates(
+        const CollisionMesh& mesh,
+        const int dim,
+        BroadPhase& broad_phase,
+        BroadPhase* codim_broad_phase,
+        const Build& build,
+        const BuildCodim& build_codim,
+        const CandidateFilter& filter,
+        Candidates& candidates)
+    {
+        candidates.clear();
+        const std::shared_ptr<BroadPhaseProfile>& candidates_profile =
+            candidates.broad_phase_profile;
+        if (candidates_profile) {
+            candidates_profile->reset();
+        }
+
+        const std::shared_ptr<BroadPhaseProfile> profile = broad_phase.profile;
+        set_mesh_filters(mesh, broad_phase);
+        broad_phase.profile = candidates_profile;
+        const auto start = std::chrono::steady_clock::now();
+        build(broad_phase);
+        if (candidates_profile) {
+            candidates_profile->build_time =
+                std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+        }
+        broad_phase.profile = profile;
+
+        // Stream the candidates through the filter, so the rejected ones are
+        // never stored.
+        const StreamFilter keep(filter);
+        const auto detect_start = std::chrono::steady_clock::now();
+        if (dim == 2) {
+            // This is not needed for 3D
+            collect_candidates<EdgeVertexCandidate>(
+                [&](const auto& visitor) {
+                    broad_phase.visit_edge_vertex_candidates(visitor);
+                },
+                keep, candidates.ev_candidates);
+        } else {
+            // These are not needed for 2D
+            collect_candidates<EdgeEdgeCandidate>(
+                [&](const auto& visitor) {
+                    broad_phase.visit_edge_edge_candidates(visitor);
+                },
+                keep, candidates.ee_candidates);
+            collect_candidates<FaceVertexCandidate>(
+                [&](const auto& visitor) {
+                    broad_phase.visit_face_vertex_candidates(visitor);
+                },
+                keep, candidates.fv_candidates);
+        }
+        if (candidates_profile) {
+            candidates_profile->detect_time =
+                std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - detect_start)
+                    .count();
         }
 
-        const size_t nCV = mesh.num_codim_vertices();
+        // Codim. edges to codim. vertices:
+        // Only need this in 3D because in 2D, the codim. edges are the same as
+        // the edges of the boundary. Only need codim. edge to codim. vertex
+        // because codim. edge to non-codim. vertex is the same as edge-edge or
+        // face-vertex.
+        if (dim == 3 && mesh.num_codim_vertices() && mesh.num_codim_edges()) {
+            // Reuse the broad phase built over the full mesh.
+            detect_codim_edge_vertex_candidates(
+                mesh, broad_phase, keep, candidates.ev_candidates);
+        }
 
-        Eigen::MatrixXd V_t0(nCV + CE_V_t0.rows(), dim);
-        V_t0.topRows(nCV) = vertices_t0(mesh.codim_vertices(), Eigen::all);
-        V_t0.bottomRows(CE_V_t0.rows()) = CE_V_t0;
+        // Codim. vertices to codim. vertices:
+        if (mesh.num_codim_vertices()) {
+            assert(codim_broad_phase != nullptr);
+            detect_codim_vertex_vertex_candidates(
+                mesh, *codim_broad_phase, build_codim, keep,
+                candidates.vv_candidates);
+        }
 
-        Eigen::MatrixXd V_t1(nCV + CE_V_t1.rows(), dim);
-        V_t1.topRows(nCV) = vertices_t1(mesh.codim_vertices(), Eigen::all);
-        V_t1.bottomRows(CE_V_t1.rows()) = CE_V_t1;
+        if (candidates_profile) {
+            // Include the rejected candidates.
+            candidates_profile->num_candidates =
+                candidates.size() + keep.num_rejected();
+        }
+    }
 
-        CE.array() += nCV; // Offset indices to account for codim. vertices
+    /// @brief Build the discrete collision detection candidates.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertex positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to build over the full collision mesh.
+    /// @param codim_broad_phase Broad phase to build over the codim. vertices (may be broad_phase).
+    /// @param filter Function returning true for the candidates to keep (empty to keep all).
+    /// @param candidates The candidates to fill.
+    void build_static_candidates(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius,
+        BroadPhase& broad_phase,
+        BroadPhase* codim_broad_phase,
+        const CandidateFilter& filter,
+        Candidates& candidates)
+    {
+        build_candidates(
+            mesh, vertices.cols(), broad_phase, codim_broad_phase,
+            [&](BroadPhase& bp) {
+                bp.build(
+                    vertices, mesh.edges(), mesh.faces(), inflation_radius);
+            },
+            [&](BroadPhase& bp) {
+                bp.build(
+                    vertices(mesh.codim_vertices(), Eigen::all), //
+                    Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
+            },
+            filter, candidates);
+    }
 
-        // TODO: Can we reuse the broad phase from above?
-        broad_phase->clear();
-        broad_phase->can_vertices_collide = [&](size_t vi, size_t vj) {
-            // Ignore c-edge to c-edge and c-vertex to c-vertex
-            return ((vi < nCV) ^ (vj < nCV)) && mesh.can_collide(vi, vj);
-        };
-        broad_phase->build(V_t0, V_t1, CE, Eigen::MatrixXi(), inflation_radius);
+    /// @brief Build the continuous collision detection candidates.
+    /// @param mesh The collision mesh.
+    /// @param vertices_t0 Vertex starting positions (rowwise).
+    /// @param vertices_t1 Vertex ending positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to build over the full collision mesh.
+    /// @param codim_broad_phase Broad phase to build over the codim. vertices (may be broad_phase).
+    /// @param candidates The candidates to fill.
+    void build_continuous_candidates(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius,
+        BroadPhase& broad_phase,
+        BroadPhase* codim_broad_phase,
+        Candidates& candidates)
+    {
+        build_candidates(
+            mesh, vertices_t0.cols(), broad_phase, codim_broad_phase,
+            [&](BroadPhase& bp) {
+                bp.build(
+                    vertices_t0, vertices_t1, mesh.edges(), mesh.faces(),
+                    inflation_radius);
+            },
+            [&](BroadPhase& bp) {
+                bp.build(
+                    vertices_t0(mesh.codim_vertices(), Eigen::all),
+                    vertices_t1(mesh.codim_vertices(), Eigen::all), //
+                    Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
+            },
+            CandidateFilter(), candidates);
+    }
 
-        broad_phase->detect_edge_vertex_candidates(ev_candidates);
-        for (auto& [ei, vi] : ev_candidates) {
-            assert(vi < mesh.codim_vertices().size());
-            ei = mesh.codim_edges()[ei];    // Map back to mesh.edges
-            vi = mesh.codim_vertices()[vi]; // Map back to vertices
-        }
+    /// @brief Make a broad phase for the codim. vertices if the mesh has any.
+    /// A separate broad phase keeps the data a persistent broad phase reuses
+    /// between builds.
+    std::shared_ptr<BroadPhase>
+    make_codim_broad_phase(const CollisionMesh& mesh)
+    {
+        return mesh.num_codim_vertices()
+            ? BroadPhase::make_broad_phase(DEFAULT_BROAD_PHASE_METHOD)
+            : nullptr;
     }
+} // namespace
+
+// The broad phase of the method overloads is not kept, so it is also rebuilt
+// over the codim. vertices.
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method)
+{
+    build(
+        mesh, vertices, inflation_radius, broad_phase_method,
+        CandidateFilter());
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method,
+    const std::function<bool(const CollisionStencil&)>& filter)
+{
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method);
+    build_static_candidates(
+        mesh, vertices, inflation_radius, *broad_phase, broad_phase.get(),
+        filter, *this);
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    const BroadPhaseMethod broad_phase_method)
+{
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method);
+    build_continuous_candidates(
+        mesh, vertices_t0, vertices_t1, inflation_radius, *broad_phase,
+        broad_phase.get(), *this);
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices,
+    const double inflation_radius,
+    BroadPhase& broad_phase)
+{
+    const std::shared_ptr<BroadPhase> codim_broad_phase =
+        make_codim_broad_phase(mesh);
+    build_static_candidates(
+        mesh, vertices, inflation_radius, broad_phase,
+        codim_broad_phase.get(), CandidateFilter(), *this);
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    const double inflation_radius,
+    BroadPhase& broad_phase)
+{
+    const std::shared_ptr<BroadPhase> codim_broad_phase =
+        make_codim_broad_phase(mesh);
+    build_continuous_candidates(
+        mesh, vertices_t0, vertices_t1, inflation_radius, broad_phase,
+        codim_broad_phase.get(), *this);
 }
 
 bool Candidates::is_step_collision_free(
@@ -193,22 +493,42 @@ bool Candidates::is_step_collision_free(
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
 
-    // Narrow phase
-    for (size_t i = 0; i < size(); i++) {
-        const ContinuousCollisionCandidate& candidate = (*this)[i];
+    // Only run the exact CCD on the candidates that may collide and stop all
+    // workers at the first collision. Any collision answers the query, so
+    // the candidates are not sorted.
+    const std::vector<std::pair<double, size_t>> filtered_candidates =
+        filter_candidates_by_toi_lower_bound(
+            *this, mesh, vertices_t0, vertices_t1, min_distance);
 
-        double toi;
-        bool is_collision = candidate.ccd(
-            candidate.dof(vertices_t0, mesh.edges(), mesh.faces()),
-            candidate.dof(vertices_t1, mesh.edges(), mesh.faces()), //
-            toi, min_distance, /*tmax=*/1.0, tolerance, max_iterations);
+    std::atomic<bool> is_collision_free(true);
+    tbb::task_group_context context;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, filtered_candidates.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (!is_collision_free.load(std::memory_order_relaxed)) {
+                    return;
+                }
 
-        if (is_collision) {
-            return false;
-        }
-    }
+                const ContinuousCollisionCandidate& candidate =
+                    (*this)[filtered_candidates[i].second];
 
-    return true;
+                double toi;
+                const bool is_collision = candidate.ccd(
+                    candidate.dof(vertices_t0, mesh.edges(), mesh.faces()),
+                    candidate.dof(vertices_t1, mesh.edges(), mesh.faces()), //
+                    toi, min_distance, /*tmax=*/1.0, tolerance, max_iterations);
+
+                if (is_collision) {
+                    is_collision_free.store(false, std::memory_order_relaxed);
+                    context.cancel_group_execution();
+                    return;
+                }
+            }
+        },
+        context);
+
+    return is_collision_free;
 }
 
 double Candidates::compute_collision_free_stepsize(
@@ -226,22 +546,35 @@ double Candidates::compute_collision_free_stepsize(
         return 1; // No possible collisions, so can take full step.
     }
 
-    double earliest_toi = 1;
-    std::shared_mutex earliest_toi_mutex;
+    // Only run the exact CCD on the candidates that may collide, in order of
+    // their lower bound so tmax shrinks as early as possible.
+    std::vector<std::pair<double, size_t>> sorted_candidates =
+        filter_candidates_by_toi_lower_bound(
+            *this, mesh, vertices_t0, vertices_t1, min_distance);
+    tbb::parallel_sort(sorted_candidates.begin(), sorted_candidates.end());
+
+    std::atomic<double> earliest_toi(1);
+    std::atomic<size_t> num_colliding(0);
 
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, size()),
+        tbb::blocked_range<size_t>(0, sorted_candidates.size()),
         [&](tbb::blocked_range<size_t> r) {
+            // Cached copy of earliest_toi, so the shared value is only read
+            // periodically instead of for every candidate.
+            double tmax = earliest_toi.load(std::memory_order_relaxed);
+
             for (size_t i = r.begin(); i < r.end(); i++) {
-                // Use the mutex to read as well in case writing double takes
-                // more than one clock cycle.
-                double tmax;
-                {
-                    std::shared_lock lock(earliest_toi_mutex);
-                    tmax = earliest_toi;
+                if ((i - r.begin()) % TMAX_REFRESH_INTERVAL == 0) {
+                    tmax = std::min(
+                        tmax, earliest_toi.load(std::memory_order_relaxed));
+                }
+
+                const auto& [toi_lower_bound, ci] = sorted_candidates[i];
+                if (toi_lower_bound >= tmax) {
+                    break; // The rest of the range has larger lower bounds.
                 }
 
-                const ContinuousCollisionCandidate& candidate = (*this)[i];
+                const ContinuousCollisionCandidate& candidate = (*this)[ci];
 
                 double toi = std::numeric_limits<double>::infinity(); // output
                 const bool are_colliding = candidate.ccd(
@@ -250,16 +583,23 @@ double Candidates::compute_collision_free_stepsize(
                     toi, min_distance, tmax, tolerance, max_iterations);
 
                 if (are_colliding) {
-                    std::unique_lock lock(earliest_toi_mutex);
-                    if (toi < earliest_toi) {
-                        earliest_toi = toi;
+                    if (broad_phase_profile) {
+                        ++num_colliding;
+                    }
+                    if (toi < tmax) {
+                        tmax = toi;
+                        atomic_min(earliest_toi, toi);
                     }
                 }
             }
         });
 
+    if (broad_phase_profile) {
+        broad_phase_profile->num_true_positives = num_colliding;
+    }
+
     assert(earliest_toi >= 0 && earliest_toi <= 1.0);
-    return earliest_toi;
+    return earliest_toi.load();
 }
 
 double Candidates::compute_noncandidate_conservative_stepsize(
@@ -278,7 +618,7 @@ double Candidates::compute_noncandidate_conservative_stepsize(
 
     std::vector<bool> is_vertex_a_candidates(mesh.num_vertices(), false);
     for (size_t i = 0; i < size(); i++) {
-        for (const long vid : (*this)[i].vertex_ids(E, F)) {
+        for (const index_t vid : (*this)[i].vertex_ids(E, F)) {
             if (vid < 0) {
                 break;
             }
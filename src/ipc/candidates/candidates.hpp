@@ -8,6 +8,7 @@
 
 #include <Eigen/Core>
 
+#include <functional>
 #include <vector>
 
 namespace ipc {
@@ -27,6 +28,22 @@ public:
         const double inflation_radius = 0,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+    /// @brief Initialize the set of discrete collision detection candidates that pass a filter.
+    /// The broad phase streams its candidates through the filter, so the
+    /// rejected candidates are never stored. The profile (if any) still counts
+    /// them in num_candidates.
+    /// @param mesh The surface of the collision mesh.
+    /// @param vertices Surface vertex positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase_method Broad phase method to use.
+    /// @param filter Function returning true for the candidates to keep. It may be called concurrently from multiple threads.
+    void build(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius,
+        const BroadPhaseMethod broad_phase_method,
+        const std::function<bool(const CollisionStencil&)>& filter);
+
     /// @brief Initialize the set of continuous collision detection candidates.
     /// @note Assumes the trajectory is linear.
     /// @param mesh The surface of the collision mesh.
@@ -41,6 +58,41 @@ public:
         const double inflation_radius = 0,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+    /// @brief Initialize the set of discrete collision detection candidates using a persistent broad phase.
+    /// The broad phase is owned by the caller, so broad phases that reuse data
+    /// between builds (e.g., a refitted BVH) do so across calls. Its filters
+    /// and static vertices are set from the mesh. The codim. vertex-vertex
+    /// candidates are found with a separate broad phase of the default
+    /// method, so the given one keeps its data.
+    /// @param mesh The surface of the collision mesh.
+    /// @param vertices Surface vertex positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to (re)build over the vertices.
+    void build(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        const double inflation_radius,
+        BroadPhase& broad_phase);
+
+    /// @brief Initialize the set of continuous collision detection candidates using a persistent broad phase.
+    /// The broad phase is owned by the caller, so broad phases that reuse data
+    /// between builds (e.g., a refitted BVH) do so across calls. Its filters
+    /// and static vertices are set from the mesh. The codim. vertex-vertex
+    /// candidates are found with a separate broad phase of the default
+    /// method, so the given one keeps its data.
+    /// @note Assumes the trajectory is linear.
+    /// @param mesh The surface of the collision mesh.
+    /// @param vertices_t0 Surface vertex starting positions (rowwise).
+    /// @param vertices_t1 Surface vertex ending positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to (re)build over the vertices.
+    void build(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices_t0,
+        const Eigen::MatrixXd& vertices_t1,
+        const double inflation_radius,
+        BroadPhase& broad_phase);
+
     size_t size() const;
 
     bool empty() const;
@@ -58,7 +110,7 @@ public:
     /// @param min_distance The minimum distance allowable between any two elements.
     /// @param tolerance The tolerance for the CCD algorithm.
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
-    /// @returns True if <b>any</b> collisions occur.
+    /// @returns True if <b>no</b> collisions occur.
     bool is_step_collision_free(
         const CollisionMesh& mesh,
         const Eigen::MatrixXd& vertices_t0,
@@ -122,6 +174,9 @@ public:
     std::vector<EdgeVertexCandidate> ev_candidates;
     std::vector<EdgeEdgeCandidate> ee_candidates;
     std::vector<FaceVertexCandidate> fv_candidates;
+
+    /// @brief Profile of the broad phase filled in by build and compute_collision_free_stepsize (nullptr to disable profiling).
+    std::shared_ptr<BroadPhaseProfile> broad_phase_profile;
 };
 
 } // namespace ipc
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
 
 #include <array>
 #include <limits>
@@ -28,7 +29,7 @@ public:
     /// @param edges Collision mesh edges
     /// @param faces Collision mesh faces
     /// @return The vertex IDs of the collision stencil. Size is always 4, but elements i > num_vertices() are -1.
-    virtual std::array<long, 4> vertex_ids(
+    virtual std::array<index_t, 4> vertex_ids(
         const Eigen::MatrixXi& edges, const Eigen::MatrixXi& faces) const = 0;
 
     /// @brief Get the vertex attributes of the collision stencil.
@@ -45,7 +46,8 @@ public:
     {
         constexpr double NaN = std::numeric_limits<double>::signaling_NaN();
 
-        const std::array<long, 4> vertex_ids = this->vertex_ids(edges, faces);
+        const std::array<index_t, 4> vertex_ids =
+            this->vertex_ids(edges, faces);
 
         std::array<VectorMax3<T>, 4> stencil_vertices;
         for (int i = 0; i < 4; i++) {
@@ -73,7 +75,7 @@ public:
     {
         const int dim = X.cols();
         VectorMax12<T> x(num_vertices() * dim);
-        const std::array<long, 4> idx = vertex_ids(edges, faces);
+        const std::array<index_t, 4> idx = vertex_ids(edges, faces);
         for (int i = 0; i < num_vertices(); i++) {
             x.segment(i * dim, dim) = X.row(idx[i]);
         }
@@ -1,7 +1,49 @@
 #include "continuous_collision_candidate.hpp"
 
+#include <limits>
+
 namespace ipc {
 
+double ContinuousCollisionCandidate::toi_lower_bound(
+    const VectorMax12d& vertices_t0,
+    const VectorMax12d& vertices_t1,
+    const double min_distance) const
+{
+    assert(vertices_t0.size() == vertices_t1.size());
+
+    const int dim = this->dim(vertices_t0.size());
+
+    const double gap = std::sqrt(compute_distance(vertices_t0)) - min_distance;
+    if (gap <= 0) {
+        return 0;
+    }
+
+    // The distance is invariant to a common translation, so measure the
+    // displacements relative to their mean (as in additive CCD).
+    VectorMax3d mean_displacement = VectorMax3d::Zero(dim);
+    for (int i = 0; i < num_vertices(); i++) {
+        mean_displacement += vertices_t1.segment(dim * i, dim)
+            - vertices_t0.segment(dim * i, dim);
+    }
+    mean_displacement /= num_vertices();
+
+    // Any point of either primitive moves by at most the largest (relative)
+    // vertex displacement, so their distance shrinks by at most twice that.
+    double max_displacement = 0;
+    for (int i = 0; i < num_vertices(); i++) {
+        max_displacement = std::max(
+            max_displacement,
+            (vertices_t1.segment(dim * i, dim)
+             - vertices_t0.segment(dim * i, dim) - mean_displacement)
+                .norm());
+    }
+
+    if (max_displacement <= 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return gap / (2 * max_displacement);
+}
+
 std::ostream& ContinuousCollisionCandidate::write_ccd_query(
     std::ostream& out,
     const VectorMax12d& vertices_t0,
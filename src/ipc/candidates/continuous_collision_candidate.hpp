@@ -34,6 +34,20 @@ public:
         const double conservative_rescaling =
             DEFAULT_CCD_CONSERVATIVE_RESCALING) const = 0;
 
+    /// @brief Compute a conservative lower bound on the time of impact.
+    ///
+    /// The distance between the primitives decreases at most by the maximum
+    /// relative displacement of their points, so the bound is the initial
+    /// distance (minus min_distance) divided by that displacement.
+    /// @param vertices_t0 Stencil vertices at the start of the time step.
+    /// @param vertices_t1 Stencil vertices at the end of the time step.
+    /// @param min_distance Minimum separation distance between primitives.
+    /// @return Lower bound on the time of impact (normalized), infinity if the primitives cannot collide.
+    double toi_lower_bound(
+        const VectorMax12d& vertices_t0,
+        const VectorMax12d& vertices_t1,
+        const double min_distance = 0.0) const;
+
     /// @brief Write the CCD query to a stream.
     /// @param out Stream to write to.
     /// @param vertices_t0 Stencil vertices at the start of the time step.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/utils/index.hpp>
+
 #include <Eigen/Core>
 
 namespace ipc {
@@ -9,7 +11,8 @@ namespace ipc {
 /// Not included in Candidates because it is not a collision candidate.
 class EdgeFaceCandidate {
 public:
-    EdgeFaceCandidate(long edge_id, long face_id);
+    EdgeFaceCandidate() = default;
+    EdgeFaceCandidate(index_t edge_id, index_t face_id);
 
     bool operator==(const EdgeFaceCandidate& other) const;
     bool operator!=(const EdgeFaceCandidate& other) const;
@@ -23,9 +26,9 @@ public:
     }
 
     /// @brief ID of the edge
-    long edge_id;
+    index_t edge_id;
     /// @brief ID of the face
-    long face_id;
+    index_t face_id;
 };
 
 } // namespace ipc
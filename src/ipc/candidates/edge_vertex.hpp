@@ -11,14 +11,15 @@ namespace ipc {
 
 class EdgeVertexCandidate : public ContinuousCollisionCandidate {
 public:
-    EdgeVertexCandidate(long edge_id, long vertex_id);
+    EdgeVertexCandidate() = default;
+    EdgeVertexCandidate(index_t edge_id, index_t vertex_id);
 
     // ------------------------------------------------------------------------
     // CollisionStencil
 
     int num_vertices() const override { return 3; };
 
-    std::array<long, 4> vertex_ids(
+    std::array<index_t, 4> vertex_ids(
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const override
     {
@@ -66,9 +67,9 @@ public:
     }
 
     /// @brief ID of the edge
-    long edge_id;
+    index_t edge_id;
     /// @brief ID of the vertex
-    long vertex_id;
+    index_t vertex_id;
 };
 
 } // namespace ipc
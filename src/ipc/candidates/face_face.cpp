@@ -2,7 +2,7 @@
 
 namespace ipc {
 
-FaceFaceCandidate::FaceFaceCandidate(long _face0_id, long _face1_id)
+FaceFaceCandidate::FaceFaceCandidate(index_t _face0_id, index_t _face1_id)
     : face0_id(_face0_id)
     , face1_id(_face1_id)
 {
@@ -24,8 +24,8 @@ bool FaceFaceCandidate::operator!=(const FaceFaceCandidate& other) const
 
 bool FaceFaceCandidate::operator<(const FaceFaceCandidate& other) const
 {
-    long this_min = std::min(this->face0_id, this->face1_id);
-    long other_min = std::min(other.face0_id, other.face1_id);
+    index_t this_min = std::min(this->face0_id, this->face1_id);
+    index_t other_min = std::min(other.face0_id, other.face1_id);
     if (this_min == other_min) {
         return std::max(this->face0_id, this->face1_id)
             < std::max(other.face0_id, other.face1_id);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/utils/index.hpp>
+
 #include <Eigen/Core>
 
 namespace ipc {
@@ -9,7 +11,8 @@ namespace ipc {
 /// @note This may be useful for nonlinear triangles in the future.
 class FaceFaceCandidate {
 public:
-    FaceFaceCandidate(long face0_id, long face1_id);
+    FaceFaceCandidate() = default;
+    FaceFaceCandidate(index_t face0_id, index_t face1_id);
 
     bool operator==(const FaceFaceCandidate& other) const;
     bool operator!=(const FaceFaceCandidate& other) const;
@@ -19,15 +22,15 @@ public:
     template <typename H>
     friend H AbslHashValue(H h, const FaceFaceCandidate& ff)
     {
-        long min_fi = std::min(ff.face0_id, ff.face1_id);
-        long max_fi = std::max(ff.face0_id, ff.face1_id);
+        index_t min_fi = std::min(ff.face0_id, ff.face1_id);
+        index_t max_fi = std::max(ff.face0_id, ff.face1_id);
         return H::combine(std::move(h), min_fi, max_fi);
     }
 
     /// @brief ID of the first face.
-    long face0_id;
+    index_t face0_id;
     /// @brief ID of the second face.
-    long face1_id;
+    index_t face1_id;
 };
 
 } // namespace ipc
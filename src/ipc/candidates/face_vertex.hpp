@@ -11,14 +11,15 @@ namespace ipc {
 
 class FaceVertexCandidate : public ContinuousCollisionCandidate {
 public:
-    FaceVertexCandidate(long face_id, long vertex_id);
+    FaceVertexCandidate() = default;
+    FaceVertexCandidate(index_t face_id, index_t vertex_id);
 
     // ------------------------------------------------------------------------
     // CollisionStencil
 
     int num_vertices() const override { return 4; };
 
-    std::array<long, 4> vertex_ids(
+    std::array<index_t, 4> vertex_ids(
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const override
     {
@@ -69,9 +70,9 @@ public:
     // ------------------------------------------------------------------------
 
     /// @brief ID of the face
-    long face_id;
+    index_t face_id;
     /// @brief ID of the vertex
-    long vertex_id;
+    index_t vertex_id;
 };
 
 } // namespace ipc
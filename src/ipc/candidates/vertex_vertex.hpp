@@ -11,7 +11,8 @@ namespace ipc {
 
 class VertexVertexCandidate : public ContinuousCollisionCandidate {
 public:
-    VertexVertexCandidate(long vertex0_id, long vertex1_id);
+    VertexVertexCandidate() = default;
+    VertexVertexCandidate(index_t vertex0_id, index_t vertex1_id);
 
     // ------------------------------------------------------------------------
     // CollisionStencil
@@ -22,7 +23,7 @@ public:
     /// @param edges edge matrix of mesh
     /// @param faces face matrix of mesh
     /// @return List of vertex indices
-    std::array<long, 4> vertex_ids(
+    std::array<index_t, 4> vertex_ids(
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const override
     {
@@ -61,15 +62,15 @@ public:
     template <typename H>
     friend H AbslHashValue(H h, const VertexVertexCandidate& vv)
     {
-        long min_vi = std::min(vv.vertex0_id, vv.vertex1_id);
-        long max_vi = std::max(vv.vertex0_id, vv.vertex1_id);
+        index_t min_vi = std::min(vv.vertex0_id, vv.vertex1_id);
+        index_t max_vi = std::max(vv.vertex0_id, vv.vertex1_id);
         return H::combine(std::move(h), min_vi, max_vi);
     }
 
     /// @brief ID of the first vertex
-    long vertex0_id;
+    index_t vertex0_id;
     /// @brief ID of the second vertex
-    long vertex1_id;
+    index_t vertex1_id;
 };
 
 } // namespace ipc
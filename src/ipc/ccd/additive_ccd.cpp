@@ -60,54 +60,6 @@ namespace {
     }
 } // namespace
 
-bool additive_ccd(
-    VectorMax12d x,
-    const VectorMax12d& dx,
-    const std::function<double(const VectorMax12d&)>& distance_squared,
-    const double max_disp_mag,
-    double& toi,
-    const double min_distance,
-    const double tmax,
-    const double conservative_rescaling)
-{
-    assert(conservative_rescaling > 0 && conservative_rescaling <= 1);
-
-    const double min_distance_sq = min_distance * min_distance;
-
-    double d, d_sq;
-    d = std::sqrt(d_sq = distance_squared(x));
-    assert(d > min_distance);
-
-    double d_func = d_sq - min_distance_sq;
-    assert(d_func > 0);
-    const double gap = // (d - ξ) = (d² - ξ²) / (d + ξ)
-        (1 - conservative_rescaling) * d_func / (d + min_distance);
-
-    toi = 0;
-    while (true) {
-        // tₗ = η ⋅ (d - ξ) / lₚ = η ⋅ (d² - ξ²) / (lₚ ⋅ (d + ξ))
-        const double toi_lower_bound = conservative_rescaling * d_func
-            / ((d + min_distance) * max_disp_mag);
-
-        x += toi_lower_bound * dx;
-
-        d = std::sqrt(d_sq = distance_squared(x));
-
-        d_func = d_sq - min_distance_sq;
-        assert(d_func > 0);
-        if (toi > 0 && d_func / (d + min_distance) < gap) {
-            break; // distance (including thickness) is less than gap
-        }
-
-        toi += toi_lower_bound;
-        if (toi > tmax) {
-            return false; // collision occurs after tmax
-        }
-    }
-
-    return true;
-}
-
 bool point_point_ccd(
     const VectorMax3d& p0_t0,
     const VectorMax3d& p1_t0,
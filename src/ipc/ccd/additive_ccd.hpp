@@ -119,20 +119,24 @@ bool edge_edge_ccd(
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
 /// @brief Computes the time of impact between two objects using additive continuous collision detection.
+/// @tparam DistanceSquared Callable as double(const VectorMax12d& x).
 /// @param distance_squared A function that computes the squared distance between the two objects at a given time.
 /// @param[out] toi The time of impact between the two objects.
 /// @param min_distance The minimum distance between the objects.
 /// @param tmax The maximum time to check for collisions.
 /// @param conservative_rescaling The amount to rescale the objects by to ensure conservative advancement.
 /// @return True if a collision was detected, false otherwise.
+template <typename DistanceSquared>
 bool additive_ccd(
     VectorMax12d x,
     const VectorMax12d& dx,
-    const std::function<double(const VectorMax12d&)>& distance_squared,
+    const DistanceSquared& distance_squared,
     const double max_disp_mag,
     double& toi,
     const double min_distance = 0.0,
     const double tmax = 1.0,
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
-} // namespace ipc::additive_ccd
\ No newline at end of file
+} // namespace ipc::additive_ccd
+
+#include "additive_ccd.tpp"
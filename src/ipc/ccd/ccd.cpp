@@ -25,66 +25,6 @@ namespace ipc {
 static constexpr double INITIAL_DISTANCE_TOLERANCE_SCALE = 0.5;
 #endif
 
-/// Special value for max_iterations to run tight inclusion without a maximum
-/// number of iterations.
-static constexpr long TIGHT_INCLUSION_UNLIMITED_ITERATIONS = -1;
-
-bool ccd_strategy(
-    const std::function<bool(
-        long /*max_iterations*/,
-        double /*min_distance*/,
-        bool /*no_zero_toi*/,
-        double& /*toi*/)>& ccd,
-    const long max_iterations,
-    const double min_distance,
-    const double initial_distance,
-    const double conservative_rescaling,
-    double& toi)
-{
-    if (check_initial_distance(initial_distance, min_distance, toi)) {
-        return true;
-    }
-
-    double min_effective_distance =
-        (1.0 - conservative_rescaling) * (initial_distance - min_distance);
-#ifndef IPC_TOOLKIT_WITH_INEXACT_CCD
-    // Tight Inclusion performs better when the minimum separation is small
-    min_effective_distance = std::min(min_effective_distance, 1e-4);
-#endif
-    min_effective_distance += min_distance;
-
-    assert(min_effective_distance < initial_distance);
-
-    // Do not use no_zero_toi because the minimum distance is arbitrary and can
-    // be removed if the query is challenging (i.e., produces small ToI).
-    bool is_impacting =
-        ccd(max_iterations, min_effective_distance, /*no_zero_toi=*/false, toi);
-
-    // #ifndef IPC_TOOLKIT_WITH_INEXACT_CCD
-    //     // Tight inclusion will have higher accuracy and better performance
-    //     // if we shrink the minimum distance. The value 1e-10 is arbitrary.
-    //     while (is_impacting && toi < CCD_SMALL_TOI && min_distance > 1e-10) {
-    //         min_distance /= 10;
-    //         is_impacting =
-    //             ccd(max_iterations, min_distance, /*no_zero_toi=*/false,
-    //             toi);
-    //     }
-    // #endif
-
-    if (is_impacting && toi < CCD_SMALL_TOI) {
-        is_impacting = ccd(
-            /*max_iterations=*/TIGHT_INCLUSION_UNLIMITED_ITERATIONS,
-            /*min_distance=*/min_distance, /*no_zero_toi=*/true, toi);
-
-        if (is_impacting) {
-            toi *= conservative_rescaling;
-            assert(toi != 0);
-        }
-    }
-
-    return is_impacting;
-}
-
 bool point_point_ccd_3D(
     const Eigen::Vector3d& p0_t0,
     const Eigen::Vector3d& p1_t0,
@@ -184,6 +184,7 @@ bool point_triangle_ccd(
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
 /// @brief Perform the CCD strategy outlined by Li et al. [2020].
+/// @tparam CCD Callable as bool(long max_iterations, double min_distance, bool no_zero_toi, double& toi).
 /// @param[in] ccd The continuous collision detection function.
 /// @param[in] max_iterations The maximum number of iterations to perform.
 /// @param[in] min_distance The minimum distance between the objects.
@@ -191,12 +192,9 @@ bool point_triangle_ccd(
 /// @param[in] conservative_rescaling The conservative rescaling of the time of impact.
 /// @param[out] toi Output time of impact.
 /// @return True if a collision was detected, false otherwise.
+template <typename CCD>
 bool ccd_strategy(
-    const std::function<bool(
-        long /*max_iterations*/,
-        double /*min_distance*/,
-        bool /*no_zero_toi*/,
-        double& /*toi*/)>& ccd,
+    const CCD& ccd,
     const long max_iterations,
     const double min_distance,
     const double initial_distance,
@@ -212,3 +210,5 @@ bool check_initial_distance(
     const double initial_distance, const double min_distance, double& toi);
 
 } // namespace ipc
+
+#include "ccd.tpp"
@@ -4,20 +4,43 @@
 #include <ipc/distance/point_edge.hpp>
 #include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/point_triangle.hpp>
+#include <ipc/utils/logger.hpp>
 
 #include <tight_inclusion/ccd.hpp>
 
-#include <stack>
+namespace ipc {
 
-// #define USE_FIXED_PIECES
+namespace detail {
+    void log_nonlinear_ccd_small_distance(double distance_ti0, double toi)
+    {
+        logger().trace(
+            "Distance small enough distance_ti0={:g}; toi={:g}", distance_ti0,
+            toi);
+    }
 
-namespace ipc {
+    void log_nonlinear_ccd_subdivision(
+        double ti0, double ti1, double min_distance, double distance_ti0)
+    {
+        logger().trace(
+            "Subdividing at ti=[{:g}, {:g}] min_distance={:g} distance_ti0={:g}",
+            ti0, ti1, min_distance, distance_ti0);
+    }
 
-#ifdef USE_FIXED_PIECES
-static constexpr size_t FIXED_NUM_PIECES = 100l;
-#else
-static constexpr size_t MAX_NUM_SUBDIVISIONS = 1000l;
-#endif
+    void log_nonlinear_ccd_evaluation(
+        double ti0,
+        double ti1,
+        double min_distance,
+        double distance_ti0,
+        bool is_impacting,
+        double toi)
+    {
+        logger().trace(
+            "Evaluated at ti=[{:g}, {:g}] min_distance={:g} distance_ti0={:g}; result={}{}",
+            ti0, ti1, min_distance, distance_ti0, is_impacting,
+            is_impacting ? fmt::format(" toi={:g}", (ti1 - ti0) * toi + ti0)
+                         : "");
+    }
+} // namespace detail
 
 // ============================================================================
 
@@ -50,105 +73,6 @@ double IntervalNonlinearTrajectory::max_distance_from_linear(
 
 // ============================================================================
 
-bool conservative_piecewise_linear_ccd(
-    const std::function<double(const double)>& distance,
-    const std::function<double(const double, const double)>&
-        max_distance_from_linear,
-    const std::function<bool(
-        const double /*ti0*/,
-        const double /*ti1*/,
-        const double /*min_distance*/,
-        const bool /*no_zero_toi*/,
-        double& /*toi*/)>& linear_ccd,
-    double& toi,
-    const double tmax,
-    const double min_sep_distance,
-    const double conservative_rescaling)
-{
-    const double distance_t0 = distance(0);
-    if (check_initial_distance(distance_t0, min_sep_distance, toi)) {
-        return true;
-    }
-    assert(distance_t0 > min_sep_distance);
-
-    double ti0 = 0;
-    std::stack<double> ts;
-
-// Initialize the stack of ts
-#ifdef USE_FIXED_PIECES
-    for (int i = FIXED_NUM_PIECES; i > 0; i--) {
-        ts.push(i / double(FIXED_NUM_PIECES) * tmax);
-    }
-    int num_subdivisions = FIXED_NUM_PIECES;
-#else
-    ts.push(tmax);
-    int num_subdivisions = 1;
-#endif
-
-    while (!ts.empty()) {
-        const double ti1 = ts.top();
-
-        const double distance_ti0 = distance(ti0);
-
-        // If distance has decreased by a factor and the toi is not near zero,
-        // then we can call this a collision.
-        if (distance_ti0 < (1 - conservative_rescaling) * distance_t0
-            && ti0 >= CCD_SMALL_TOI) {
-            toi = ti0;
-            logger().trace(
-                "Distance small enough distance_ti0={:g}; toi={:g}",
-                distance_ti0, toi);
-            return true;
-        }
-
-        double min_distance = max_distance_from_linear(ti0, ti1);
-
-#ifndef USE_FIXED_PIECES
-        // Check if the minimum distance is too large and we need to subdivide
-        // (Large distances cause the slow CCD)
-        if ((min_distance
-             >= std::min((1 - conservative_rescaling) * distance_ti0, 0.01))
-            && (num_subdivisions < MAX_NUM_SUBDIVISIONS || ti0 == 0)) {
-            logger().trace(
-                "Subdividing at ti=[{:g}, {:g}] min_distance={:g} distance_ti0={:g}",
-                ti0, ti1, min_distance, distance_ti0);
-            ts.push((ti1 + ti0) / 2);
-            num_subdivisions++;
-            continue;
-        }
-#endif
-
-        min_distance += min_sep_distance;
-
-        const bool is_impacting =
-            linear_ccd(ti0, ti1, min_distance, /*no_zero_toi=*/ti0 == 0, toi);
-
-        logger().trace(
-            "Evaluated at ti=[{:g}, {:g}] min_distance={:g} distance_ti0={:g}; result={}{}",
-            ti0, ti1, min_distance, distance_ti0, is_impacting,
-            is_impacting ? fmt::format(" toi={:g}", (ti1 - ti0) * toi + ti0)
-                         : "");
-
-        if (is_impacting) {
-            toi = (ti1 - ti0) * toi + ti0;
-            if (toi == 0) {
-                // This is impossible because distance_t0 > min_sep_distance
-                ts.push((ti1 + ti0) / 2);
-                num_subdivisions++;
-                continue;
-            }
-            return true;
-        }
-
-        ts.pop();
-        ti0 = ti1;
-    }
-
-    return false;
-}
-
-// ============================================================================
-
 bool point_point_nonlinear_ccd(
     const NonlinearTrajectory& p0,
     const NonlinearTrajectory& p1,
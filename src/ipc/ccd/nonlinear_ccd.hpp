@@ -7,8 +7,6 @@
 #include <ipc/utils/interval.hpp>
 #endif
 
-#include <functional>
-
 namespace ipc {
 
 /// @brief A nonlinear trajectory is a function that maps time to a point in space.
@@ -137,6 +135,9 @@ bool point_triangle_nonlinear_ccd(
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
 /// @brief Perform conservative piecewise linear CCD of a nonlinear trajectories.
+/// @tparam Distance Callable as double(double t).
+/// @tparam MaxDistanceFromLinear Callable as double(double t0, double t1).
+/// @tparam LinearCCD Callable as bool(double ti0, double ti1, double min_distance, bool no_zero_toi, double& toi).
 /// @param[in] distance Return the distance for a given time in [0, 1].
 /// @param[in] max_distance_from_linear Return the maximum distance from the linearized trajectory for a given time interval.
 /// @param[in] linear_ccd Perform linear CCD on a given time interval.
@@ -145,19 +146,16 @@ bool point_triangle_nonlinear_ccd(
 /// @param[in] min_distance Minimum separation distance between the objects.
 /// @param[in] conservative_rescaling Conservative rescaling of the time of impact.
 /// @return
+template <typename Distance, typename MaxDistanceFromLinear, typename LinearCCD>
 bool conservative_piecewise_linear_ccd(
-    const std::function<double(const double)>& distance,
-    const std::function<double(const double, const double)>&
-        max_distance_from_linear,
-    const std::function<bool(
-        const double /*ti0*/,
-        const double /*ti1*/,
-        const double /*min_distance*/,
-        const bool /*no_zero_toi*/,
-        double& /*toi*/)>& linear_ccd,
+    const Distance& distance,
+    const MaxDistanceFromLinear& max_distance_from_linear,
+    const LinearCCD& linear_ccd,
     double& toi,
     const double tmax = 1.0,
     const double min_distance = 0,
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
 } // namespace ipc
+
+#include "nonlinear_ccd.tpp"
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "nonlinear_ccd.hpp"
+
+#include <vector>
+
+// #define USE_FIXED_PIECES
+
+namespace ipc {
+
+namespace detail {
+    /// @brief Log that the distance decreased enough to report a collision.
+    void log_nonlinear_ccd_small_distance(double distance_ti0, double toi);
+
+    /// @brief Log the subdivision of a time interval.
+    void log_nonlinear_ccd_subdivision(
+        double ti0, double ti1, double min_distance, double distance_ti0);
+
+    /// @brief Log the result of the linear CCD over a time interval.
+    /// @note toi is relative to the interval [ti0, ti1].
+    void log_nonlinear_ccd_evaluation(
+        double ti0,
+        double ti1,
+        double min_distance,
+        double distance_ti0,
+        bool is_impacting,
+        double toi);
+} // namespace detail
+
+template <typename Distance, typename MaxDistanceFromLinear, typename LinearCCD>
+bool conservative_piecewise_linear_ccd(
+    const Distance& distance,
+    const MaxDistanceFromLinear& max_distance_from_linear,
+    const LinearCCD& linear_ccd,
+    double& toi,
+    const double tmax,
+    const double min_sep_distance,
+    const double conservative_rescaling)
+{
+    const double distance_t0 = distance(0);
+    if (check_initial_distance(distance_t0, min_sep_distance, toi)) {
+        return true;
+    }
+    assert(distance_t0 > min_sep_distance);
+
+#ifdef USE_FIXED_PIECES
+    constexpr size_t FIXED_NUM_PIECES = 100l;
+#else
+    constexpr size_t MAX_NUM_SUBDIVISIONS = 1000l;
+#endif
+
+    double ti0 = 0;
+    std::vector<double> ts; // stack of the ends of the time intervals
+
+// Initialize the stack of ts
+#ifdef USE_FIXED_PIECES
+    for (int i = FIXED_NUM_PIECES; i > 0; i--) {
+        ts.push_back(i / double(FIXED_NUM_PIECES) * tmax);
+    }
+    int num_subdivisions = FIXED_NUM_PIECES;
+#else
+    ts.push_back(tmax);
+    int num_subdivisions = 1;
+#endif
+
+    while (!ts.empty()) {
+        const double ti1 = ts.back();
+
+        const double distance_ti0 = distance(ti0);
+
+        // If distance has decreased by a factor and the toi is not near zero,
+        // then we can call this a collision.
+        if (distance_ti0 < (1 - conservative_rescaling) * distance_t0
+            && ti0 >= CCD_SMALL_TOI) {
+            toi = ti0;
+            detail::log_nonlinear_ccd_small_distance(distance_ti0, toi);
+            return true;
+        }
+
+        double min_distance = max_distance_from_linear(ti0, ti1);
+
+#ifndef USE_FIXED_PIECES
+        // Check if the minimum distance is too large and we need to subdivide
+        // (Large distances cause the slow CCD)
+        if ((min_distance
+             >= std::min((1 - conservative_rescaling) * distance_ti0, 0.01))
+            && (num_subdivisions < MAX_NUM_SUBDIVISIONS || ti0 == 0)) {
+            detail::log_nonlinear_ccd_subdivision(
+                ti0, ti1, min_distance, distance_ti0);
+            ts.push_back((ti1 + ti0) / 2);
+            num_subdivisions++;
+            continue;
+        }
+#endif
+
+        min_distance += min_sep_distance;
+
+        const bool is_impacting =
+            linear_ccd(ti0, ti1, min_distance, /*no_zero_toi=*/ti0 == 0, toi);
+
+        detail::log_nonlinear_ccd_evaluation(
+            ti0, ti1, min_distance, distance_ti0, is_impacting, toi);
+
+        if (is_impacting) {
+            toi = (ti1 - ti0) * toi + ti0;
+            if (toi == 0) {
+                // This is impossible because distance_t0 > min_sep_distance
+                ts.push_back((ti1 + ti0) / 2);
+                num_subdivisions++;
+                continue;
+            }
+            return true;
+        }
+
+        ts.pop_back();
+        ti0 = ti1;
+    }
+
+    return false;
+}
+
+} // namespace ipc
@@ -5,20 +5,43 @@
 #include <ipc/utils/eigen_ext.hpp>
 #include <ipc/utils/local_to_global.hpp>
 #include <ipc/utils/area_gradient.hpp>
+#include <ipc/utils/morton.hpp>
+
+#include <numeric>
 
 namespace ipc {
 
+namespace {
+    /// @brief Compute the order of a set of points along a Morton curve.
+    /// @param points Points to order (rowwise).
+    /// @return Indices of the points in Morton order.
+    std::vector<int> morton_order(const Eigen::MatrixXd& points)
+    {
+        std::vector<uint64_t> codes;
+        morton_codes(points, codes);
+
+        std::vector<int> order(points.rows());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return codes[a] < codes[b];
+        });
+        return order;
+    }
+} // namespace
+
 CollisionMesh::CollisionMesh(
     const Eigen::MatrixXd& rest_positions,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
-    const Eigen::SparseMatrix<double>& displacement_map)
+    const Eigen::SparseMatrix<double>& displacement_map,
+    const bool reorder)
     : CollisionMesh(
         std::vector<bool>(rest_positions.rows(), true),
         rest_positions,
         edges,
         faces,
-        displacement_map)
+        displacement_map,
+        reorder)
 {
 }
 
@@ -27,7 +50,8 @@ CollisionMesh::CollisionMesh(
     const Eigen::MatrixXd& full_rest_positions,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
-    const Eigen::SparseMatrix<double>& displacement_map)
+    const Eigen::SparseMatrix<double>& displacement_map,
+    const bool reorder)
     : m_full_rest_positions(full_rest_positions)
     , m_edges(edges)
     , m_faces(faces)
@@ -56,6 +80,10 @@ CollisionMesh::CollisionMesh(
             dynamic_vertex_to_full_vertex.size());
     }
 
+    if (reorder) {
+        reorder_vertices(full_rest_positions);
+    }
+
     // ========================================================================
 
     const int dim = full_rest_positions.cols();
@@ -84,8 +112,8 @@ CollisionMesh::CollisionMesh(
     m_rest_positions = m_select_vertices * full_rest_positions;
     // m_rest_positions = vertices(full_rest_positions);
 
-    // Map faces and edges to only included vertices
-    if (!include_all_vertices) {
+    // Map faces and edges to only included (and reordered) vertices
+    if (!include_all_vertices || reorder) {
         for (int i = 0; i < m_edges.rows(); i++) {
             for (int j = 0; j < m_edges.cols(); j++) {
                 long new_id = m_full_vertex_to_vertex[m_edges(i, j)];
@@ -103,6 +131,10 @@ CollisionMesh::CollisionMesh(
         }
     } // else no need to change the edges and faces
 
+    if (reorder) {
+        reorder_edges_and_faces();
+    }
+
     m_faces_to_edges = construct_faces_to_edges(m_faces, m_edges);
 
     init_codim_vertices();
@@ -115,6 +147,45 @@ CollisionMesh::CollisionMesh(
 
 // ============================================================================
 
+void CollisionMesh::reorder_vertices(const Eigen::MatrixXd& full_rest_positions)
+{
+    const std::vector<int> order =
+        morton_order(full_rest_positions(m_vertex_to_full_vertex, Eigen::all));
+
+    m_vertex_to_full_vertex = m_vertex_to_full_vertex(order).eval();
+    for (int vi = 0; vi < m_vertex_to_full_vertex.size(); vi++) {
+        m_full_vertex_to_vertex[m_vertex_to_full_vertex[vi]] = vi;
+    }
+}
+
+void CollisionMesh::reorder_edges_and_faces()
+{
+    if (m_edges.rows() > 0) {
+        const Eigen::MatrixXd midpoints =
+            (m_rest_positions(m_edges.col(0), Eigen::all)
+             + m_rest_positions(m_edges.col(1), Eigen::all))
+            / 2;
+        const std::vector<int> order = morton_order(midpoints);
+        m_edges = m_edges(order, Eigen::all).eval();
+        m_edge_to_input_edge =
+            Eigen::Map<const Eigen::VectorXi>(order.data(), order.size());
+    }
+
+    if (m_faces.rows() > 0) {
+        const Eigen::MatrixXd centroids =
+            (m_rest_positions(m_faces.col(0), Eigen::all)
+             + m_rest_positions(m_faces.col(1), Eigen::all)
+             + m_rest_positions(m_faces.col(2), Eigen::all))
+            / 3;
+        const std::vector<int> order = morton_order(centroids);
+        m_faces = m_faces(order, Eigen::all).eval();
+        m_face_to_input_face =
+            Eigen::Map<const Eigen::VectorXi>(order.data(), order.size());
+    }
+}
+
+// ============================================================================
+
 void CollisionMesh::init_codim_vertices()
 {
     std::vector<bool> is_codim_vertex(num_vertices(), true);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ipc/utils/collision_groups.hpp>
 #include <ipc/utils/unordered_map_and_set.hpp>
 
 #include <Eigen/Core>
@@ -19,12 +20,14 @@ public:
     /// @param edges The edges of the collision mesh (#E × 2).
     /// @param faces The faces of the collision mesh (#F × 3).
     /// @param displacement_map The displacement mapping from displacements on the full mesh to the collision mesh.
+    /// @param reorder Reorder the vertices, edges, and faces along a Morton curve for memory locality (see the other constructor).
     CollisionMesh(
         const Eigen::MatrixXd& rest_positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const Eigen::SparseMatrix<double>& displacement_map =
-            Eigen::SparseMatrix<double>());
+            Eigen::SparseMatrix<double>(),
+        const bool reorder = false);
 
     /// @brief Construct a new Collision Mesh object from a full mesh vertices.
     /// @param include_vertex Vector of bools indicating whether each vertex should be included in the collision mesh.
@@ -32,27 +35,38 @@ public:
     /// @param edges The edges of the collision mesh indexed into the full mesh vertices (#E × 2).
     /// @param faces The faces of the collision mesh indexed into the full mesh vertices (#F × 3).
     /// @param displacement_map The displacement mapping from displacements on the full mesh to the collision mesh.
+    /// @param reorder Reorder the vertices, edges, and faces along a Morton curve of their rest positions for memory locality.
+    /// The collision vertices are then a permutation of the included full
+    /// vertices, so always compute them with vertices() or
+    /// displace_vertices(). Use to_input_edge_id() and to_input_face_id() to
+    /// map edges and faces back to the given rows. can_collide,
+    /// collision_groups, and is_vertex_static are indexed by the permuted
+    /// collision vertex IDs (see to_full_vertex_id()).
     CollisionMesh(
         const std::vector<bool>& include_vertex,
         const Eigen::MatrixXd& full_rest_positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const Eigen::SparseMatrix<double>& displacement_map =
-            Eigen::SparseMatrix<double>());
+            Eigen::SparseMatrix<double>(),
+        const bool reorder = false);
 
     /// @brief Helper function that automatically builds include_vertex using construct_is_on_surface.
     /// @param full_rest_positions The full vertices at rest (#FV × dim).
     /// @param edges The edge matrix of mesh (#E × 2).
     /// @param faces The face matrix of mesh (#F × 3).
+    /// @param reorder Reorder the vertices, edges, and faces along a Morton curve of their rest positions for memory locality (see the constructor).
     /// @return Constructed CollisionMesh.
     static CollisionMesh build_from_full_mesh(
         const Eigen::MatrixXd& full_rest_positions,
         const Eigen::MatrixXi& edges,
-        const Eigen::MatrixXi& faces)
+        const Eigen::MatrixXi& faces,
+        const bool reorder = false)
     {
         return CollisionMesh(
             construct_is_on_surface(full_rest_positions.rows(), edges),
-            full_rest_positions, edges, faces);
+            full_rest_positions, edges, faces, Eigen::SparseMatrix<double>(),
+            reorder);
     }
 
     // The following functions are used to initialize optional data structures.
@@ -149,6 +163,24 @@ public:
         return m_vertex_to_full_vertex[id];
     }
 
+    /// @brief Map an edge ID to the row of the edges given at construction.
+    /// @param id Edge ID in the collision mesh.
+    /// @return Row of the edge in the edges given at construction.
+    size_t to_input_edge_id(const size_t id) const
+    {
+        assert(id < num_edges());
+        return m_edge_to_input_edge.size() ? m_edge_to_input_edge[id] : id;
+    }
+
+    /// @brief Map a face ID to the row of the faces given at construction.
+    /// @param id Face ID in the collision mesh.
+    /// @return Row of the face in the faces given at construction.
+    size_t to_input_face_id(const size_t id) const
+    {
+        assert(id < num_faces());
+        return m_face_to_input_face.size() ? m_face_to_input_face[id] : id;
+    }
+
     /// @brief Map a vector quantity on the collision mesh to the full mesh.
     /// This is useful for mapping gradients from the collision mesh to the full
     /// mesh (i.e., applies the chain-rule).
@@ -284,6 +316,22 @@ public:
     /// primitives can collide with all other primitives.
     std::function<bool(size_t, size_t)> can_collide = default_can_collide;
 
+    /// Built-in collision groups of the vertices. Two vertices can collide only
+    /// if both collision_groups and can_collide allow it. Prefer this over
+    /// can_collide because the broad phase can inline it. By default there are
+    /// no groups.
+    CollisionGroups collision_groups;
+
+    /// Flags marking the static vertices (i.e., vertices that never move). A
+    /// primitive is static if all of its vertices are static. Static
+    /// primitives are never checked against each other by a
+    /// StaticDynamicSplit broad phase passed to Candidates::build. By default
+    /// (empty) no vertex is static.
+    std::vector<bool> is_vertex_static;
+
+    /// @brief The default can_collide function (all primitives can collide).
+    static bool default_can_collide(size_t, size_t) { return true; }
+
 protected:
     // -----------------------------------------------------------------------
     // Helper initialization functions
@@ -291,6 +339,20 @@ protected:
     void init_codim_vertices();
     void init_codim_edges();
 
+    /// @brief Permute the collision vertices along a Morton curve of their rest positions.
+    /// Everything indexed by collision vertex (including can_collide,
+    /// collision_groups, and is_vertex_static, which are set after
+    /// construction) uses the permuted IDs, so callers must translate their
+    /// vertex IDs with to_full_vertex_id().
+    /// @param full_rest_positions The vertices of the full mesh at rest (#FV × dim).
+    void reorder_vertices(const Eigen::MatrixXd& full_rest_positions);
+
+    /// @brief Permute the edges and faces along a Morton curve of their rest centroids.
+    /// Edge and face IDs (e.g., of the candidates and collisions) are the
+    /// permuted IDs, so callers must translate them with to_input_edge_id()
+    /// and to_input_face_id().
+    void reorder_edges_and_faces();
+
     /// @brief Initialize the selection matrix from full vertices/DOF to collision vertices/DOF.
     void init_selection_matrices(const int dim);
 
@@ -317,6 +379,10 @@ protected:
     Eigen::MatrixXi m_faces;
     /// @brief Map from faces edges to rows of edges (#F × 3).
     Eigen::MatrixXi m_faces_to_edges;
+    /// @brief Map from edges to rows of the input edges (empty if not reordered).
+    Eigen::VectorXi m_edge_to_input_edge;
+    /// @brief Map from faces to rows of the input faces (empty if not reordered).
+    Eigen::VectorXi m_face_to_input_face;
 
     /// @brief Map from full vertices to collision vertices.
     /// @note Negative values indicate full vertex is dropped.
@@ -362,10 +428,6 @@ protected:
     std::vector<Eigen::SparseVector<double>> m_vertex_area_jacobian;
     /// @brief The rows of the Jacobian of the edge areas vector.
     std::vector<Eigen::SparseVector<double>> m_edge_area_jacobian;
-
-private:
-    /// @brief By default all primitives can collide with all other primitives.
-    static int default_can_collide(size_t, size_t) { return true; }
 };
 
 } // namespace ipc
@@ -13,6 +13,7 @@
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
 
+#include <atomic>
 #include <stdexcept> // std::out_of_range
 
 namespace ipc {
@@ -148,8 +149,19 @@ void Collisions::build(
 
     double inflation_radius = (dhat + dmin) / 2;
 
+    // Only store the candidates within the activation distance. The derived
+    // candidates of the convergent formulation are never closer than the
+    // candidate they come from, so they are unaffected.
+    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
     Candidates candidates;
-    candidates.build(mesh, vertices, inflation_radius, broad_phase_method);
+    candidates.broad_phase_profile = broad_phase_profile;
+    candidates.build(
+        mesh, vertices, inflation_radius, broad_phase_method,
+        [&](const CollisionStencil& candidate) {
+            return candidate.compute_distance(candidate.dof(
+                       vertices, mesh.edges(), mesh.faces()))
+                < offset_sqr;
+        });
 
     this->build(candidates, mesh, vertices, dhat, dmin);
 }
@@ -172,6 +184,21 @@ void Collisions::build(
         return distance_sqr < offset_sqr;
     };
 
+    // Count the candidates that pass the distance filter for the profile.
+    std::atomic<size_t> num_active(0);
+    const std::function<bool(double)> is_active_and_count =
+        [&](double distance_sqr) {
+            const bool active = is_active(distance_sqr);
+            if (active) {
+                ++num_active;
+            }
+            return active;
+        };
+    const std::function<bool(double)> candidate_is_active =
+        candidates.broad_phase_profile
+        ? is_active_and_count
+        : std::function<bool(double)>(is_active);
+
     tbb::enumerable_thread_specific<CollisionsBuilder> storage(
         use_convergent_formulation(), are_shape_derivatives_enabled());
 
@@ -179,32 +206,32 @@ void Collisions::build(
         tbb::blocked_range<size_t>(size_t(0), candidates.vv_candidates.size()),
         [&](const tbb::blocked_range<size_t>& r) {
             storage.local().add_vertex_vertex_collisions(
-                mesh, vertices, candidates.vv_candidates, is_active, r.begin(),
-                r.end());
+                mesh, vertices, candidates.vv_candidates, candidate_is_active,
+                r.begin(), r.end());
         });
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), candidates.ev_candidates.size()),
         [&](const tbb::blocked_range<size_t>& r) {
             storage.local().add_edge_vertex_collisions(
-                mesh, vertices, candidates.ev_candidates, is_active, r.begin(),
-                r.end());
+                mesh, vertices, candidates.ev_candidates, candidate_is_active,
+                r.begin(), r.end());
         });
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), candidates.ee_candidates.size()),
         [&](const tbb::blocked_range<size_t>& r) {
             storage.local().add_edge_edge_collisions(
-                mesh, vertices, candidates.ee_candidates, is_active, r.begin(),
-                r.end());
+                mesh, vertices, candidates.ee_candidates, candidate_is_active,
+                r.begin(), r.end());
         });
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), candidates.fv_candidates.size()),
         [&](const tbb::blocked_range<size_t>& r) {
             storage.local().add_face_vertex_collisions(
-                mesh, vertices, candidates.fv_candidates, is_active, r.begin(),
-                r.end());
+                mesh, vertices, candidates.fv_candidates, candidate_is_active,
+                r.begin(), r.end());
         });
 
     if (use_convergent_formulation()) {
@@ -270,6 +297,10 @@ void Collisions::build(
 
     CollisionsBuilder::merge(storage, *this);
 
+    if (candidates.broad_phase_profile) {
+        candidates.broad_phase_profile->num_true_positives = num_active;
+    }
+
     // logger().debug(to_string(mesh, vertices));
 
     for (size_t ci = 0; ci < size(); ci++) {
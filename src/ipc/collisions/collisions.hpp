@@ -142,6 +142,9 @@ public:
     std::vector<FaceVertexCollision> fv_collisions;
     std::vector<PlaneVertexCollision> pv_collisions;
 
+    /// @brief Profile of the broad phase filled in by build (nullptr to disable profiling).
+    std::shared_ptr<BroadPhaseProfile> broad_phase_profile;
+
 protected:
     bool m_use_convergent_formulation = false;
     bool m_are_shape_derivatives_enabled = false;
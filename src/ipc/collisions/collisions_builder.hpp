@@ -92,8 +92,8 @@ protected:
         std::vector<VertexVertexCollision>& vv_collisions);
 
     void add_vertex_vertex_collision(
-        const long vertex0_id,
-        const long vertex1_id,
+        const index_t vertex0_id,
+        const index_t vertex1_id,
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient)
     {
@@ -111,8 +111,8 @@ protected:
         std::vector<EdgeVertexCollision>& ev_collisions);
 
     void add_edge_vertex_collision(
-        const long edge_id,
-        const long vertex_id,
+        const index_t edge_id,
+        const index_t vertex_id,
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient)
     {
@@ -136,8 +136,8 @@ protected:
         std::vector<EdgeEdgeCollision>& ee_collisions);
 
     void add_edge_edge_collision(
-        const long edge0_id,
-        const long edge1_id,
+        const index_t edge0_id,
+        const index_t edge1_id,
         const double eps_x,
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient,
@@ -9,8 +9,8 @@ namespace ipc {
 class EdgeEdgeCollision : public EdgeEdgeCandidate, public Collision {
 public:
     EdgeEdgeCollision(
-        const long edge0_id,
-        const long edge1_id,
+        const index_t edge0_id,
+        const index_t edge1_id,
         const double eps_x,
         const EdgeEdgeDistanceType dtype = EdgeEdgeDistanceType::AUTO);
 
@@ -20,8 +20,8 @@ public:
         const EdgeEdgeDistanceType dtype = EdgeEdgeDistanceType::AUTO);
 
     EdgeEdgeCollision(
-        const long edge0_id,
-        const long edge1_id,
+        const index_t edge0_id,
+        const index_t edge1_id,
         const double eps_x,
         const double weight,
         const Eigen::SparseVector<double>& weight_gradient,
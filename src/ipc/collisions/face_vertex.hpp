@@ -15,8 +15,8 @@ public:
     }
 
     FaceVertexCollision(
-        const long _face_id,
-        const long _vertex_id,
+        const index_t _face_id,
+        const index_t _vertex_id,
         const double _weight,
         const Eigen::SparseVector<double>& _weight_gradient)
         : FaceVertexCandidate(_face_id, _vertex_id)
@@ -10,11 +10,11 @@ public:
     PlaneVertexCollision(
         const VectorMax3d& plane_origin,
         const VectorMax3d& plane_normal,
-        const long vertex_id);
+        const index_t vertex_id);
 
     int num_vertices() const override { return 1; };
 
-    std::array<long, 4> vertex_ids(
+    std::array<index_t, 4> vertex_ids(
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const override
     {
@@ -45,7 +45,7 @@ public:
     VectorMax3d plane_normal;
 
     /// @brief The vertex's id.
-    long vertex_id;
+    index_t vertex_id;
 };
 
 } // namespace ipc
@@ -1,5 +1,6 @@
 #include "ipc.hpp"
 
+#include <ipc/broad_phase/broad_phase_filter_guard.hpp>
 #include <ipc/candidates/candidates.hpp>
 #include <ipc/utils/intersection.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
@@ -11,9 +12,94 @@
 #endif
 
 #include <igl/predicates/segment_segment_intersect.h>
+#include <tbb/task_group.h>
+
+#include <atomic>
 
 namespace ipc {
 
+namespace {
+    /// @brief Check if any streamed candidate passes a test, stopping at the first one.
+    ///
+    /// The test runs in parallel inside the broad phase's traversal. The first
+    /// candidate that passes cancels the traversal (and any parallel
+    /// algorithms nested in it) through a shared task group context.
+    ///
+    /// @tparam Candidate Type of candidate streamed by the broad phase.
+    /// @param visit Function streaming the candidates to a visitor.
+    /// @param test Function testing a candidate (must be thread-safe).
+    /// @return True if any candidate passes the test.
+    template <typename Candidate, typename Visit, typename Test>
+    bool any_candidate_of(const Visit& visit, const Test& test)
+    {
+        std::atomic<bool> found(false);
+        tbb::task_group_context context;
+        tbb::task_group tasks(context);
+        tasks.run_and_wait([&] {
+            visit([&](const Candidate& candidate) {
+                if (!found.load(std::memory_order_relaxed) && test(candidate)) {
+                    found.store(true, std::memory_order_relaxed);
+                    context.cancel_group_execution();
+                }
+            });
+        });
+        return found;
+    }
+
+    /// @brief Build a broad phase and check its candidates for intersections.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param broad_phase Broad phase (with its filters set) to build.
+    /// @return A boolean for if the mesh has intersections.
+    bool has_candidate_intersections(
+        const CollisionMesh& mesh,
+        const Eigen::MatrixXd& vertices,
+        BroadPhase& broad_phase)
+    {
+        const double conservative_inflation_radius =
+            1e-6 * world_bbox_diagonal_length(vertices);
+
+        broad_phase.build(
+            vertices, mesh.edges(), mesh.faces(),
+            conservative_inflation_radius);
+
+        if (vertices.cols() == 2) {
+            // Need to check segment-segment intersections in 2D
+            igl::predicates::exactinit();
+            return any_candidate_of<EdgeEdgeCandidate>(
+                [&](const auto& visitor) {
+                    broad_phase.visit_edge_edge_candidates(visitor);
+                },
+                [&](const EdgeEdgeCandidate& candidate) {
+                    // narrow-phase using igl
+                    const auto& [ea_id, eb_id] = candidate;
+                    return igl::predicates::segment_segment_intersect(
+                        vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
+                        vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
+                        vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
+                        vertices.row(mesh.edges()(eb_id, 1)).head<2>());
+                });
+        } else {
+            // Need to check segment-triangle intersections in 3D
+            assert(vertices.cols() == 3);
+
+            return any_candidate_of<EdgeFaceCandidate>(
+                [&](const auto& visitor) {
+                    broad_phase.visit_edge_face_candidates(visitor);
+                },
+                [&](const EdgeFaceCandidate& candidate) {
+                    const auto& [e_id, f_id] = candidate;
+                    return is_edge_intersecting_triangle(
+                        vertices.row(mesh.edges()(e_id, 0)),
+                        vertices.row(mesh.edges()(e_id, 1)),
+                        vertices.row(mesh.faces()(f_id, 0)),
+                        vertices.row(mesh.faces()(f_id, 1)),
+                        vertices.row(mesh.faces()(f_id, 2)));
+                });
+        }
+    }
+} // namespace
+
 bool is_step_collision_free(
     const CollisionMesh& mesh,
     const Eigen::MatrixXd& vertices_t0,
@@ -38,6 +124,30 @@ bool is_step_collision_free(
         max_iterations);
 }
 
+bool is_step_collision_free(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    BroadPhase& broad_phase,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    // Broad phase
+    Candidates candidates;
+    candidates.build(
+        mesh, vertices_t0, vertices_t1,
+        /*inflation_radius=*/min_distance / 2, broad_phase);
+
+    // Narrow phase
+    return candidates.is_step_collision_free(
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations);
+}
+
 // ============================================================================
 
 double compute_collision_free_stepsize(
@@ -84,6 +194,30 @@ double compute_collision_free_stepsize(
         max_iterations);
 }
 
+double compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    BroadPhase& broad_phase,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    // Broad phase
+    Candidates candidates;
+    candidates.build(
+        mesh, vertices_t0, vertices_t1, /*inflation_radius=*/min_distance / 2,
+        broad_phase);
+
+    // Narrow phase
+    return candidates.compute_collision_free_stepsize(
+        mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+        max_iterations);
+}
+
 // ============================================================================
 
 bool has_intersections(
@@ -93,54 +227,49 @@ bool has_intersections(
 {
     assert(vertices.rows() == mesh.num_vertices());
 
-    const double conservative_inflation_radius =
-        1e-6 * world_bbox_diagonal_length(vertices);
-
     std::shared_ptr<BroadPhase> broad_phase =
         BroadPhase::make_broad_phase(broad_phase_method);
     broad_phase->can_vertices_collide = mesh.can_collide;
+    broad_phase->collision_groups = mesh.collision_groups;
 
-    broad_phase->build(
-        vertices, mesh.edges(), mesh.faces(), conservative_inflation_radius);
-
-    if (vertices.cols() == 2) {
-        // Need to check segment-segment intersections in 2D
-        std::vector<EdgeEdgeCandidate> ee_candidates;
-
-        broad_phase->detect_edge_edge_candidates(ee_candidates);
-        broad_phase->clear();
-
-        // narrow-phase using igl
-        igl::predicates::exactinit();
-        for (const auto& [ea_id, eb_id] : ee_candidates) {
-            if (igl::predicates::segment_segment_intersect(
-                    vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 1)).head<2>())) {
-                return true;
-            }
-        }
-    } else {
-        // Need to check segment-triangle intersections in 3D
-        assert(vertices.cols() == 3);
-
-        std::vector<EdgeFaceCandidate> ef_candidates;
-        broad_phase->detect_edge_face_candidates(ef_candidates);
-        broad_phase->clear();
-
-        for (const auto& [e_id, f_id] : ef_candidates) {
-            if (is_edge_intersecting_triangle(
-                    vertices.row(mesh.edges()(e_id, 0)),
-                    vertices.row(mesh.edges()(e_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 0)),
-                    vertices.row(mesh.faces()(f_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 2)))) {
-                return true;
-            }
-        }
+    return has_candidate_intersections(mesh, vertices, *broad_phase);
+}
+
+bool has_intersections(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_verified,
+    const Eigen::MatrixXd& vertices,
+    const double displacement_tolerance,
+    BroadPhase& broad_phase)
+{
+    assert(vertices_verified.rows() == mesh.num_vertices());
+    assert(vertices.rows() == mesh.num_vertices());
+
+    const Eigen::VectorXd displacement_lengths_sq =
+        (vertices - vertices_verified).rowwise().squaredNorm();
+    const double tolerance_sq = displacement_tolerance * displacement_tolerance;
+
+    std::vector<bool> is_vertex_moved(mesh.num_vertices());
+    bool any_vertex_moved = false;
+    for (size_t vi = 0; vi < is_vertex_moved.size(); vi++) {
+        is_vertex_moved[vi] = displacement_lengths_sq[vi] > tolerance_sq;
+        any_vertex_moved |= is_vertex_moved[vi];
+    }
+    if (!any_vertex_moved) {
+        return false;
     }
 
-    return false;
+    // The caller's filters are restored on return.
+    const BroadPhaseFilterGuard filter_guard(broad_phase);
+
+    // Pairs of primitives at rest are skipped because the vertices of a
+    // primitive can collide if any pair of them can.
+    broad_phase.can_vertices_collide = [&](size_t vi, size_t vj) {
+        return (is_vertex_moved[vi] || is_vertex_moved[vj])
+            && mesh.can_collide(vi, vj);
+    };
+    broad_phase.collision_groups = mesh.collision_groups;
+
+    return has_candidate_intersections(mesh, vertices, broad_phase);
 }
 } // namespace ipc
@@ -31,6 +31,27 @@ bool is_step_collision_free(
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
 
+/// @brief Determine if the step is collision free using a persistent broad phase.
+/// The broad phase is owned by the caller, so broad phases that reuse data
+/// between builds (e.g., a refitted BVH) do so across calls.
+/// @note Assumes the trajectory is linear.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param broad_phase Broad phase to (re)build over the vertices.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @returns True if <b>any</b> collisions occur.
+bool is_step_collision_free(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    BroadPhase& broad_phase,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
+
 /// @brief Computes a maximal step size that is collision free.
 /// @note Assumes the trajectory is linear.
 /// @param mesh The collision mesh.
@@ -50,10 +71,33 @@ double compute_collision_free_stepsize(
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
 
+/// @brief Computes a maximal step size that is collision free using a persistent broad phase.
+/// The broad phase is owned by the caller, so broad phases that reuse data
+/// between builds (e.g., a refitted BVH) do so across calls.
+/// @note Assumes the trajectory is linear.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param broad_phase Broad phase to (re)build over the vertices.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+double compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_t0,
+    const Eigen::MatrixXd& vertices_t1,
+    BroadPhase& broad_phase,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
+
 // ============================================================================
 // Utilities
 
 /// @brief Determine if the mesh has self intersections.
+/// The narrow phase runs in parallel on the candidates streamed by the broad
+/// phase and stops at the first intersection found.
 /// @param mesh The collision mesh.
 /// @param vertices Vertices of the collision mesh.
 /// @param broad_phase_method The broad phase method to use.
@@ -63,4 +107,25 @@ bool has_intersections(
     const Eigen::MatrixXd& vertices,
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+/// @brief Determine if the mesh has self intersections involving primitives that moved since an intersection-free state.
+/// Only pairs of primitives where at least one vertex moved more than the
+/// displacement tolerance are tested, so the narrow phase only runs on the
+/// moving part of the mesh. The broad phase is rebuilt every call, so reuse
+/// the same broad phase across calls; when the topology does not change, a
+/// BVH with enable_refit or a HashGrid with enable_update avoids rebuilding
+/// it from scratch. Its can_vertices_collide and collision_groups are
+/// restored before returning.
+/// @param mesh The collision mesh.
+/// @param vertices_verified Vertices of the last state known to be intersection-free.
+/// @param vertices Vertices of the collision mesh to check.
+/// @param displacement_tolerance Vertices that moved at most this distance are considered at rest.
+/// @param broad_phase Persistent broad phase to (re)build over the vertices.
+/// @return A boolean for if the mesh has intersections.
+bool has_intersections(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& vertices_verified,
+    const Eigen::MatrixXd& vertices,
+    const double displacement_tolerance,
+    BroadPhase& broad_phase);
+
 } // namespace ipc
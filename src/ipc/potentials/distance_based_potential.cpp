@@ -140,7 +140,7 @@ MatrixMax12d DistanceBasedPotential::hessian(
 
 void DistanceBasedPotential::shape_derivative(
     const Collision& collision,
-    const std::array<long, 4>& vertex_ids,
+    const std::array<index_t, 4>& vertex_ids,
     const VectorMax12d& rest_positions, // = x̄
     const VectorMax12d& positions,      // = x̄ + u
     std::vector<Eigen::Triplet<double>>& out) const
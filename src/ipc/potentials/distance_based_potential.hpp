@@ -66,7 +66,7 @@ public:
     /// @param[in,out] out Store the triplets of the shape derivative here.
     void shape_derivative(
         const Collision& collision,
-        const std::array<long, 4>& vertex_ids,
+        const std::array<index_t, 4>& vertex_ids,
         const VectorMax12d& rest_positions,
         const VectorMax12d& positions,
         std::vector<Eigen::Triplet<double>>& out) const;
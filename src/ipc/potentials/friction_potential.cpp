@@ -44,7 +44,7 @@ Eigen::VectorXd FrictionPotential::force(
                     collision.dof(velocities, edges, faces), //
                     barrier_potential, barrier_stiffness, dmin, no_mu);
 
-                const std::array<long, 4> vis =
+                const std::array<index_t, 4> vis =
                     collision.vertex_ids(mesh.edges(), mesh.faces());
 
                 local_gradient_to_global_gradient(
@@ -93,7 +93,7 @@ Eigen::SparseMatrix<double> FrictionPotential::force_jacobian(
                     collision.dof(velocities, edges, faces), //
                     barrier_potential, barrier_stiffness, wrt, dmin);
 
-                const std::array<long, 4> vis =
+                const std::array<index_t, 4> vis =
                     collision.vertex_ids(mesh.edges(), mesh.faces());
 
                 local_hessian_to_global_triplets(
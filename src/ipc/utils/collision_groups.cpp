@@ -0,0 +1,72 @@
+#include "collision_groups.hpp"
+
+#include <stdexcept> // std::invalid_argument
+
+namespace ipc {
+
+CollisionGroups::CollisionGroups(
+    const Eigen::VectorXi& vertex_groups,
+    const std::vector<uint64_t>& group_masks)
+    : m_vertex_groups(vertex_groups)
+    , m_group_masks(group_masks)
+{
+    const size_t num_groups = m_group_masks.size();
+    if (num_groups > MAX_GROUPS) {
+        throw std::invalid_argument(
+            "CollisionGroups supports at most 64 groups!");
+    }
+
+    for (int i = 0; i < m_vertex_groups.size(); i++) {
+        if (m_vertex_groups[i] < 0
+            || size_t(m_vertex_groups[i]) >= num_groups) {
+            throw std::invalid_argument(
+                "CollisionGroups vertex group id out of range!");
+        }
+    }
+
+    for (size_t i = 0; i < num_groups; i++) {
+        for (size_t j = 0; j < num_groups; j++) {
+            if (((m_group_masks[i] >> j) & 1)
+                != ((m_group_masks[j] >> i) & 1)) {
+                throw std::invalid_argument(
+                    "CollisionGroups group masks must be symmetric!");
+            }
+        }
+    }
+}
+
+CollisionGroups
+CollisionGroups::inter_group_only(const Eigen::VectorXi& vertex_groups)
+{
+    const size_t num_groups =
+        vertex_groups.size() == 0 ? 0 : (vertex_groups.maxCoeff() + 1);
+    if (num_groups > MAX_GROUPS) {
+        throw std::invalid_argument(
+            "CollisionGroups supports at most 64 groups!");
+    }
+
+    const uint64_t all_groups = num_groups == MAX_GROUPS
+        ? ~uint64_t(0)
+        : ((uint64_t(1) << num_groups) - 1);
+
+    std::vector<uint64_t> group_masks(num_groups);
+    for (size_t i = 0; i < num_groups; i++) {
+        group_masks[i] = all_groups & ~(uint64_t(1) << i);
+    }
+
+    return CollisionGroups(vertex_groups, group_masks);
+}
+
+CollisionGroups CollisionGroups::select(const Eigen::VectorXi& vertex_ids) const
+{
+    if (empty()) {
+        return CollisionGroups();
+    }
+
+    CollisionGroups selected;
+    selected.m_vertex_groups = m_vertex_groups(vertex_ids);
+    selected.m_group_masks = m_group_masks;
+    return selected;
+}
+
+} // namespace ipc
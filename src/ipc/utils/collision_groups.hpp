@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Built-in vertex collision filter based on collision groups.
+///
+/// Each vertex belongs to a group and each group has a bitmask of the groups
+/// it can collide with. Unlike a std::function filter, this can be inlined in
+/// the inner loops of the broad phase.
+class CollisionGroups {
+public:
+    /// @brief Maximum number of groups (one bit per group in a mask).
+    static constexpr size_t MAX_GROUPS = 64;
+
+    /// @brief Construct empty collision groups (all vertices can collide).
+    CollisionGroups() = default;
+
+    /// @brief Construct collision groups from per-vertex group ids and per-group masks.
+    /// @param vertex_groups Group id of each vertex (#V × 1).
+    /// @param group_masks Bit j of group_masks[i] is set if groups i and j can collide. The masks must be symmetric.
+    CollisionGroups(
+        const Eigen::VectorXi& vertex_groups,
+        const std::vector<uint64_t>& group_masks);
+
+    /// @brief Construct collision groups where only vertices of different groups can collide.
+    /// @param vertex_groups Group id of each vertex (#V × 1).
+    /// @return Constructed collision groups.
+    static CollisionGroups
+    inter_group_only(const Eigen::VectorXi& vertex_groups);
+
+    /// @brief Determine if two vertices can collide.
+    /// @param vi ID of the first vertex.
+    /// @param vj ID of the second vertex.
+    /// @return True if the groups of the vertices can collide.
+    bool operator()(size_t vi, size_t vj) const
+    {
+        assert(vi < num_vertices() && vj < num_vertices());
+        return (m_group_masks[m_vertex_groups[vi]] >> m_vertex_groups[vj]) & 1;
+    }
+
+    /// @brief Collision groups restricted to a subset of the vertices.
+    /// @param vertex_ids IDs of the vertices to keep.
+    /// @return Collision groups indexed by position in vertex_ids.
+    CollisionGroups select(const Eigen::VectorXi& vertex_ids) const;
+
+    /// @brief Are there no collision groups (i.e., all vertices can collide)?
+    bool empty() const { return m_vertex_groups.size() == 0; }
+
+    /// @brief Get the number of vertices with a group.
+    size_t num_vertices() const { return m_vertex_groups.size(); }
+
+    /// @brief Get the group id of each vertex (#V × 1).
+    const Eigen::VectorXi& vertex_groups() const { return m_vertex_groups; }
+
+    /// @brief Get the collision mask of each group.
+    const std::vector<uint64_t>& group_masks() const { return m_group_masks; }
+
+protected:
+    /// @brief Group id of each vertex.
+    Eigen::VectorXi m_vertex_groups;
+    /// @brief Bitmask of the groups each group can collide with.
+    std::vector<uint64_t> m_group_masks;
+};
+
+} // namespace ipc
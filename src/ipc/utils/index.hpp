@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#include <cstdint>
+
+namespace ipc {
+
+/// @brief Integer type used to store vertex, edge, and face indices in
+/// candidates, collisions, and hash grid items.
+///
+/// Defaults to 32 bits, which halves the memory footprint (and bandwidth) of
+/// large candidate and collision sets. Enable the CMake option
+/// IPC_TOOLKIT_WITH_64BIT_INDICES for meshes with more than 2^31 - 1 elements.
+#ifdef IPC_TOOLKIT_WITH_64BIT_INDICES
+using index_t = int64_t;
+#else
+using index_t = int32_t;
+#endif
+
+} // namespace ipc
@@ -1,27 +1,73 @@
 #pragma once
 
+#include <ipc/utils/unordered_map_and_set.hpp>
+
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 
 namespace ipc {
 
+/// @brief Append the items of thread-local vectors to a vector.
+///
+/// If T is default constructible (e.g., the candidate types), the output is
+/// resized once and the items are copied in parallel using the prefix sum of
+/// the thread-local sizes. The resize value-initializes the new items
+/// serially, but this is a plain fill that is cheaper than the copy.
+/// Otherwise, the output is reserved once and each thread's items are
+/// appended in turn.
+/// @param vectors Thread-local vectors to merge.
+/// @param out Vector the items are appended to.
 template <typename T>
 void merge_thread_local_vectors(
     const tbb::enumerable_thread_specific<std::vector<T>>& vectors,
     std::vector<T>& out)
 {
-    // size up the items
-    size_t size = out.size();
+    // Offsets of the non-empty thread-local vectors in the output
+    std::vector<const std::vector<T>*> segments;
+    std::vector<size_t> offsets = { out.size() };
     for (const auto& vector : vectors) {
-        size += vector.size();
+        if (!vector.empty()) {
+            segments.push_back(&vector);
+            offsets.push_back(offsets.back() + vector.size());
+        }
     }
-    // serial merge!
-    out.reserve(size);
-    for (const auto& vector : vectors) {
-        out.insert(out.end(), vector.begin(), vector.end());
+
+    if constexpr (std::is_default_constructible_v<T>) {
+        out.resize(offsets.back());
+        tbb::parallel_for(size_t(0), segments.size(), [&](size_t s) {
+            const std::vector<T>& segment = *segments[s];
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), segment.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    std::copy(
+                        segment.begin() + r.begin(), segment.begin() + r.end(),
+                        out.begin() + offsets[s] + r.begin());
+                });
+        });
+    } else {
+        out.reserve(offsets.back());
+        for (const std::vector<T>* segment : segments) {
+            out.insert(out.end(), segment->begin(), segment->end());
+        }
     }
 }
 
+/// @brief Collect the items emitted, possibly concurrently, by a function.
+/// @param emit_all Function taking a callback and calling it on each item.
+/// @param out Vector the items are appended to.
+template <typename T, typename EmitAll>
+void collect_thread_local_vectors(EmitAll emit_all, std::vector<T>& out)
+{
+    tbb::enumerable_thread_specific<std::vector<T>> storage;
+    emit_all([&](const T& item) { storage.local().push_back(item); });
+    merge_thread_local_vectors(storage, out);
+}
+
 template <typename T>
 void merge_thread_local_unordered_sets(
     const tbb::enumerable_thread_specific<unordered_set<T>>& sets,
@@ -0,0 +1,45 @@
+#include "morton.hpp"
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace ipc {
+
+void morton_codes(const Eigen::MatrixXd& points, std::vector<uint64_t>& codes)
+{
+    assert(points.cols() == 2 || points.cols() == 3);
+
+    codes.resize(points.rows());
+    if (points.rows() == 0) {
+        return;
+    }
+
+    const bool is_3D = points.cols() == 3;
+    // 21 bits per axis in 3D and 32 bits per axis in 2D
+    const double max_coord = is_3D ? double((1 << 21) - 1) : 4294967295.0;
+
+    const Eigen::RowVectorXd min = points.colwise().minCoeff();
+    const Eigen::RowVectorXd extent = points.colwise().maxCoeff() - min;
+    const double scale = max_coord / std::max(extent.maxCoeff(), 1e-300);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), codes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                uint64_t code = 0;
+                for (int d = 0; d < points.cols(); d++) {
+                    const double q = std::clamp(
+                        (points(i, d) - min[d]) * scale, 0.0, max_coord);
+                    code |= (is_3D ? expand_bits_3D(uint64_t(q))
+                                   : expand_bits_2D(uint64_t(q)))
+                        << d;
+                }
+                codes[i] = code;
+            }
+        });
+}
+
+} // namespace ipc
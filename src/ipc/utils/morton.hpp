@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Spread the lower 21 bits of x so there are two zero bits between each.
+/// @param x Value to spread.
+/// @return The spread bits.
+inline uint64_t expand_bits_3D(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+/// @brief Spread the lower 32 bits of x so there is one zero bit between each.
+/// @param x Value to spread.
+/// @return The spread bits.
+inline uint64_t expand_bits_2D(uint64_t x)
+{
+    x &= 0xffffffff;
+    x = (x | x << 16) & 0x0000ffff0000ffff;
+    x = (x | x << 8) & 0x00ff00ff00ff00ff;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | x << 2) & 0x3333333333333333;
+    x = (x | x << 1) & 0x5555555555555555;
+    return x;
+}
+
+/// @brief Compute the Morton (Z-order) codes of a set of points.
+/// The points are quantized relative to their bounding box, so the codes only
+/// define an ordering and are not comparable across different point sets.
+/// @param[in] points Points to encode (rowwise).
+/// @param[out] codes Morton code of each point.
+void morton_codes(
+    const Eigen::MatrixXd& points, std::vector<uint64_t>& codes);
+
+} // namespace ipc
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <tbb/parallel_for.h>
+#include <tbb/info.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Stable parallel least-significant-digit radix sort.
+///
+/// Each pass sorts by eight bits of the key. Passes where every key has the
+/// same digit are skipped, so sorting keys with few significant bits is cheap.
+/// @tparam T Type of the items to sort.
+/// @tparam KeyFn Callable mapping an item to an unsigned integer key.
+/// @param[in,out] items Items to sort (in increasing order of their keys).
+/// @param[in] key Function mapping an item to its key.
+/// @param[in] key_bits Number of low bits of the key to sort by.
+template <typename T, typename KeyFn>
+void radix_sort(std::vector<T>& items, KeyFn key, const int key_bits = 64)
+{
+    constexpr int RADIX_BITS = 8;
+    constexpr size_t RADIX = size_t(1) << RADIX_BITS;
+    constexpr size_t MIN_BLOCK_SIZE = size_t(1) << 14;
+
+    const size_t n = items.size();
+    if (n <= MIN_BLOCK_SIZE) {
+        // Not worth the extra buffer and histograms.
+        std::stable_sort(
+            items.begin(), items.end(), [&](const T& a, const T& b) {
+                return key(a) < key(b);
+            });
+        return;
+    }
+
+    const size_t num_blocks = std::min<size_t>(
+        4 * tbb::info::default_concurrency(),
+        (n + MIN_BLOCK_SIZE - 1) / MIN_BLOCK_SIZE);
+    const size_t block_size = (n + num_blocks - 1) / num_blocks;
+
+    std::vector<T> buffer(n);
+    std::vector<std::array<size_t, RADIX>> offsets(num_blocks);
+
+    for (int shift = 0; shift < key_bits; shift += RADIX_BITS) {
+        const auto digit = [&](const T& item) -> size_t {
+            return (uint64_t(key(item)) >> shift) & (RADIX - 1);
+        };
+
+        // Count the digits in each block.
+        tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+            offsets[b].fill(0);
+            const size_t end = std::min(n, (b + 1) * block_size);
+            for (size_t i = b * block_size; i < end; i++) {
+                offsets[b][digit(items[i])]++;
+            }
+        });
+
+        // Exclusive prefix sum over (digit, block) so the sort is stable.
+        size_t sum = 0;
+        bool is_sorted = false;
+        for (size_t d = 0; d < RADIX && !is_sorted; d++) {
+            size_t digit_count = 0;
+            for (size_t b = 0; b < num_blocks; b++) {
+                const size_t count = offsets[b][d];
+                offsets[b][d] = sum;
+                sum += count;
+                digit_count += count;
+            }
+            // All keys have the same digit, so this pass is a no-op.
+            is_sorted = digit_count == n;
+        }
+        if (is_sorted) {
+            continue;
+        }
+
+        // Scatter each block into its slots.
+        tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+            const size_t end = std::min(n, (b + 1) * block_size);
+            for (size_t i = b * block_size; i < end; i++) {
+                buffer[offsets[b][digit(items[i])]++] = items[i];
+            }
+        });
+
+        items.swap(buffer);
+    }
+}
+
+} // namespace ipc
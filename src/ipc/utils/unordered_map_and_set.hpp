@@ -40,7 +40,11 @@ template <class T> struct Hash {
 
     size_t operator()(const T& t) const
     {
-        return AbslHashValue<Hash>(*this, t);
+        if constexpr (std::is_default_constructible<std::hash<T>>::value) {
+            return std::hash<T>()(t);
+        } else {
+            return AbslHashValue<Hash>(*this, t);
+        }
     }
 
     operator size_t() const { return hash; }
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <ipc/broad_phase/aabb.hpp>
 
@@ -104,3 +105,87 @@ TEST_CASE("AABB overlapping", "[broad_phase][AABB]")
     }
     CHECK(a.intersects(b) == are_overlapping);
 }
+
+TEST_CASE("Compact AABBs", "[broad_phase][AABB]")
+{
+    const int dim = GENERATE(2, 3);
+    CAPTURE(dim);
+
+    // Values that are not exactly representable as floats
+    const ArrayMax3d min = ArrayMax3d::Constant(dim, 0.1);
+    const ArrayMax3d max = ArrayMax3d::Constant(dim, 1.0 / 3.0);
+
+    CompactAABBs boxes;
+    boxes.resize(2, dim);
+    boxes.set(0, min, max);
+
+    // The stored box must contain the original box
+    const AABB box = boxes.box(0);
+    CHECK((box.min <= min).all());
+    CHECK((box.max >= max).all());
+
+    SECTION("touching")
+    {
+        boxes.set(1, max, max + 1);
+        CHECK(boxes.intersects(0, boxes, 1));
+        CHECK(boxes.intersects(1, boxes, 0));
+    }
+    SECTION("separated")
+    {
+        boxes.set(1, max + 1e-6, max + 1);
+        CHECK(!boxes.intersects(0, boxes, 1));
+        CHECK(!boxes.intersects(1, boxes, 0));
+    }
+    SECTION("union")
+    {
+        boxes.set(1, -max, -min);
+        CompactAABBs nodes;
+        nodes.resize(1, dim);
+        nodes.set(0, boxes, 0);
+        CHECK(nodes.intersects(0, boxes, 0));
+        CHECK(!nodes.intersects(0, boxes, 1));
+
+        boxes.resize(3, dim);
+        boxes.set_union(2, 0, 1);
+        CHECK(boxes.intersects(2, boxes, 0));
+        CHECK(boxes.intersects(2, boxes, 1));
+    }
+}
+
+TEST_CASE("Batched compact AABB overlap", "[broad_phase][AABB]")
+{
+    const int dim = GENERATE(2, 3);
+    CAPTURE(dim);
+
+    constexpr int N = 100;
+    CompactAABBs boxes;
+    boxes.resize(N, dim);
+    for (int i = 0; i < N; i++) {
+        const ArrayMax3d min = ArrayMax3d::Random(dim);
+        const ArrayMax3d max = min + 0.5 * (ArrayMax3d::Random(dim) + 1);
+        boxes.set(i, min, max);
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int count = 0; count <= CompactAABBs::BATCH_SIZE; count++) {
+            const int j_begin = (7 * i) % (N - count + 1);
+
+            std::array<int, CompactAABBs::BATCH_SIZE> js;
+            uint32_t expected_range = 0, expected_batch = 0;
+            for (int k = 0; k < count; k++) {
+                js[k] = (13 * i + 31 * k) % N;
+                expected_range |=
+                    uint32_t(boxes.intersects(i, boxes, j_begin + k)) << k;
+                expected_batch |= uint32_t(boxes.intersects(i, boxes, js[k]))
+                    << k;
+            }
+
+            CHECK(
+                boxes.intersects_range(i, boxes, j_begin, count)
+                == expected_range);
+            CHECK(
+                boxes.intersects_batch(i, boxes, js.data(), count)
+                == expected_batch);
+        }
+    }
+}
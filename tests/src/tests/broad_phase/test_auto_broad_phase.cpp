@@ -0,0 +1,127 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/auto_broad_phase.hpp>
+#include <ipc/broad_phase/brute_force.hpp>
+
+using namespace ipc;
+
+TEST_CASE("Auto broad phase method selection", "[broad_phase][auto]")
+{
+    BroadPhaseStatistics statistics;
+    statistics.num_vertices = 10000;
+    statistics.num_edges = 30000;
+    statistics.num_faces = 20000;
+    statistics.mean_edge_length = 1;
+    statistics.edge_length_std_deviation = 0.1;
+    statistics.max_edge_length = 1.5;
+
+    SECTION("Small mesh")
+    {
+        statistics.num_vertices = 8;
+        statistics.num_edges = 18;
+        statistics.num_faces = 12;
+        CHECK(
+            AutoBroadPhase::select_method(statistics)
+            == BroadPhaseMethod::BRUTE_FORCE);
+    }
+    SECTION("Small motion")
+    {
+        statistics.mean_displacement_length = 0.01;
+        statistics.max_displacement_length = 0.05;
+        CHECK(
+            AutoBroadPhase::select_method(statistics)
+            == BroadPhaseMethod::SWEEP_AND_PRUNE);
+    }
+    SECTION("Uniform motion")
+    {
+        statistics.mean_displacement_length = 1;
+        statistics.displacement_length_std_deviation = 0.2;
+        statistics.max_displacement_length = 2;
+        CHECK(
+            AutoBroadPhase::select_method(statistics)
+            == BroadPhaseMethod::HASH_GRID);
+    }
+    SECTION("Varying element size")
+    {
+        statistics.max_edge_length = 100;
+        CHECK(
+            AutoBroadPhase::select_method(statistics) == BroadPhaseMethod::BVH);
+    }
+    SECTION("Varying displacement")
+    {
+        statistics.mean_displacement_length = 0.5;
+        statistics.max_displacement_length = 50;
+        CHECK(
+            AutoBroadPhase::select_method(statistics) == BroadPhaseMethod::BVH);
+    }
+}
+
+TEST_CASE("Auto broad phase", "[broad_phase][auto]")
+{
+    const bool calibrate = GENERATE(false, true);
+    CAPTURE(calibrate);
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V0, E, F));
+
+    AutoBroadPhase auto_broad_phase;
+    auto_broad_phase.calibrate = calibrate;
+    auto_broad_phase.profile = std::make_shared<BroadPhaseProfile>();
+    // Only forwarded, because none of the selectable methods use them.
+    auto_broad_phase.is_vertex_static.assign(V0.rows(), false);
+    auto_broad_phase.is_vertex_static[0] = true;
+    CHECK(auto_broad_phase.selected_method() == BroadPhaseMethod::AUTO);
+
+    BruteForce bf;
+
+    const double inflation_radius = 1e-3;
+    std::shared_ptr<BroadPhase> previous_broad_phase;
+    for (int i = 0; i < 2; i++) {
+        const Eigen::MatrixXd V1 = V0.array() + 1e-4;
+
+        auto_broad_phase.build(V0, V1, E, F, inflation_radius);
+        bf.build(V0, V1, E, F, inflation_radius);
+
+        CHECK(auto_broad_phase.selected_method() != BroadPhaseMethod::AUTO);
+        REQUIRE(auto_broad_phase.selected_broad_phase() != nullptr);
+
+        // Only the selected broad phase is recorded, not the calibration
+        // trials.
+        CHECK(
+            auto_broad_phase.profile->num_boxes
+            == size_t(V0.rows() + E.rows() + F.rows()));
+        CHECK(auto_broad_phase.profile->num_candidates == 0);
+        CHECK(
+            auto_broad_phase.selected_broad_phase()->profile
+            == auto_broad_phase.profile);
+        CHECK(
+            auto_broad_phase.selected_broad_phase()->is_vertex_static
+            == auto_broad_phase.is_vertex_static);
+        if (previous_broad_phase != nullptr) {
+            // Same statistics so the selection is reused
+            CHECK(
+                auto_broad_phase.selected_broad_phase()
+                == previous_broad_phase);
+        }
+        previous_broad_phase = auto_broad_phase.selected_broad_phase();
+
+        std::vector<EdgeEdgeCandidate> ee_candidates, expected_ee_candidates;
+        auto_broad_phase.detect_edge_edge_candidates(ee_candidates);
+        bf.detect_edge_edge_candidates(expected_ee_candidates);
+        tests::check_candidates(ee_candidates, expected_ee_candidates);
+
+        std::vector<FaceVertexCandidate> fv_candidates, expected_fv_candidates;
+        auto_broad_phase.detect_face_vertex_candidates(fv_candidates);
+        bf.detect_face_vertex_candidates(expected_fv_candidates);
+        tests::check_candidates(fv_candidates, expected_fv_candidates);
+
+        V0 = V1;
+    }
+
+    auto_broad_phase.clear();
+    CHECK(auto_broad_phase.selected_method() == BroadPhaseMethod::AUTO);
+}
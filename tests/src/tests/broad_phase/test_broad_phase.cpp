@@ -3,6 +3,7 @@
 #include <tests/utils.hpp>
 
 #include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/collisions/collisions.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -10,6 +11,8 @@
 #include <igl/readCSV.h>
 #include <igl/readDMAT.h>
 
+#include <tbb/enumerable_thread_specific.h>
+
 using namespace ipc;
 
 void test_face_face_broad_phase(
@@ -240,6 +243,151 @@ TEST_CASE("Compare BP against brute force", "[broad_phase]")
     }
 }
 
+TEST_CASE("Stream broad phase candidates", "[broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+    const Eigen::MatrixXd V1 = V0 + Eigen::MatrixXd::Random(V0.rows(), 3);
+
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    broad_phase->build(V0, V1, E, F, 1e-2);
+
+    std::vector<EdgeEdgeCandidate> expected_ee;
+    broad_phase->detect_edge_edge_candidates(expected_ee);
+    std::vector<FaceVertexCandidate> expected_fv;
+    broad_phase->detect_face_vertex_candidates(expected_fv);
+
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> ee_storage;
+    broad_phase->visit_edge_edge_candidates(
+        [&](const EdgeEdgeCandidate& c) { ee_storage.local().push_back(c); });
+    std::vector<EdgeEdgeCandidate> ee;
+    for (const auto& local_ee : ee_storage) {
+        ee.insert(ee.end(), local_ee.begin(), local_ee.end());
+    }
+
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>>
+        fv_storage;
+    broad_phase->visit_face_vertex_candidates(
+        [&](const FaceVertexCandidate& c) { fv_storage.local().push_back(c); });
+    std::vector<FaceVertexCandidate> fv;
+    for (const auto& local_fv : fv_storage) {
+        fv.insert(fv.end(), local_fv.begin(), local_fv.end());
+    }
+
+    tests::check_candidates(ee, expected_ee);
+
+    tests::check_candidates(fv, expected_fv);
+}
+
+TEST_CASE("Broad phase collision groups", "[broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+    const Eigen::MatrixXd V1 = V0 + Eigen::MatrixXd::Random(V0.rows(), 3);
+
+    Eigen::VectorXi group_ids(V0.rows());
+    for (int i = 0; i < group_ids.size(); i++) {
+        group_ids(i) = i % 3;
+    }
+
+    // Groups 0 and 1 can collide with each other, group 2 only with itself.
+    const CollisionGroups groups(group_ids, { 0b011, 0b011, 0b100 });
+    CHECK(groups(0, 1));
+    CHECK(!groups(0, 2));
+    CHECK(groups(2, 5));
+
+    std::shared_ptr<BroadPhase> grouped = BroadPhase::make_broad_phase(method);
+    grouped->collision_groups = groups;
+    grouped->build(V0, V1, E, F, 1e-2);
+
+    std::shared_ptr<BroadPhase> filtered = BroadPhase::make_broad_phase(method);
+    filtered->can_vertices_collide = [&](size_t vi, size_t vj) {
+        return groups(vi, vj);
+    };
+    filtered->build(V0, V1, E, F, 1e-2);
+
+    std::vector<EdgeEdgeCandidate> ee, expected_ee;
+    grouped->detect_edge_edge_candidates(ee);
+    filtered->detect_edge_edge_candidates(expected_ee);
+    tests::check_candidates(ee, expected_ee);
+
+    std::vector<FaceVertexCandidate> fv, expected_fv;
+    grouped->detect_face_vertex_candidates(fv);
+    filtered->detect_face_vertex_candidates(expected_fv);
+    tests::check_candidates(fv, expected_fv);
+
+    // Both filters combined are the intersection of the two.
+    grouped->can_vertices_collide = [](size_t, size_t) { return false; };
+    std::vector<EdgeEdgeCandidate> none;
+    grouped->detect_edge_edge_candidates(none);
+    CHECK(none.empty());
+
+    CHECK_THROWS(CollisionGroups(group_ids, { 0b011, 0b001, 0b100 }));
+    CHECK_THROWS(CollisionGroups(group_ids, { 0b1, 0b1 }));
+}
+
+TEST_CASE("Broad phase profile", "[broad_phase][profile]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+    const Eigen::MatrixXd V1 = V0 + Eigen::MatrixXd::Random(V0.rows(), 3);
+
+    SECTION("Broad phase")
+    {
+        std::shared_ptr<BroadPhase> broad_phase =
+            BroadPhase::make_broad_phase(method);
+        broad_phase->profile = std::make_shared<BroadPhaseProfile>();
+        broad_phase->build(V0, V1, E, F, 1e-2);
+
+        const BroadPhaseProfile& profile = *broad_phase->profile;
+        CHECK(profile.num_boxes == V0.rows() + E.rows() + F.rows());
+        CHECK(profile.memory_usage > 0);
+        CHECK(profile.box_build_time >= 0);
+
+        Candidates candidates;
+        broad_phase->detect_collision_candidates(3, candidates);
+        CHECK(profile.num_candidates == candidates.size());
+        CHECK(profile.detect_time >= 0);
+        CHECK(profile.false_positive_ratio() == (candidates.empty() ? 0 : 1));
+    }
+
+    SECTION("Collisions")
+    {
+        const CollisionMesh mesh(V0, E, F);
+        const double dhat = 0.1;
+
+        Collisions collisions;
+        collisions.broad_phase_profile = std::make_shared<BroadPhaseProfile>();
+        collisions.build(mesh, V1, dhat, /*dmin=*/0, method);
+
+        const BroadPhaseProfile& profile = *collisions.broad_phase_profile;
+        CHECK(profile.num_boxes > 0);
+        CHECK(profile.build_time >= profile.box_build_time);
+        CHECK(profile.num_true_positives <= profile.num_candidates);
+        CHECK(profile.false_positive_ratio() >= 0);
+        CHECK(profile.false_positive_ratio() <= 1);
+        if (!collisions.empty()) {
+            CHECK(profile.num_true_positives > 0);
+        }
+
+        collisions.broad_phase_profile->reset();
+        CHECK(profile.num_candidates == 0);
+    }
+}
+
 TEST_CASE("Cloth-Ball", "[ccd][broad_phase][cloth-ball][.]")
 {
     Eigen::MatrixXd V0, V1;
@@ -0,0 +1,70 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/bvh.hpp>
+#include <ipc/candidates/candidates.hpp>
+
+using namespace ipc;
+
+TEST_CASE("Refit BVH", "[broad_phase][bvh]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    const double rebuild_threshold = GENERATE(1.0, 2.0, 1e6);
+    const double inflation_radius = 1e-2;
+
+    BVH bvh(/*enable_refit=*/true, rebuild_threshold);
+    BruteForce bf;
+
+    Eigen::MatrixXd V = V0;
+    for (int i = 0; i < 3; i++) {
+        bvh.build(V, E, F, inflation_radius);
+        bf.build(V, E, F, inflation_radius);
+
+        std::vector<EdgeEdgeCandidate> ee_candidates, bf_ee_candidates;
+        bvh.detect_edge_edge_candidates(ee_candidates);
+        bf.detect_edge_edge_candidates(bf_ee_candidates);
+        tests::check_candidates(ee_candidates, bf_ee_candidates);
+
+        std::vector<FaceVertexCandidate> fv_candidates, bf_fv_candidates;
+        bvh.detect_face_vertex_candidates(fv_candidates);
+        bf.detect_face_vertex_candidates(bf_fv_candidates);
+        tests::check_candidates(fv_candidates, bf_fv_candidates);
+
+        // Perturb the vertices so the refitted tree differs from a fresh one
+        V = V0 + 0.5 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+    }
+}
+
+TEST_CASE("Refit BVH through candidates", "[broad_phase][bvh][candidates]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+    const CollisionMesh mesh(V0, E, F);
+
+    const double inflation_radius = 1e-2;
+
+    // The same BVH is refitted by every build of the candidates.
+    BVH bvh(/*enable_refit=*/true);
+
+    Eigen::MatrixXd V1 = V0;
+    for (int i = 0; i < 3; i++) {
+        Candidates candidates, bf_candidates;
+        candidates.build(mesh, V0, V1, inflation_radius, bvh);
+        bf_candidates.build(
+            mesh, V0, V1, inflation_radius, BroadPhaseMethod::BRUTE_FORCE);
+
+        tests::check_candidates(
+            candidates.ee_candidates, bf_candidates.ee_candidates);
+        tests::check_candidates(
+            candidates.fv_candidates, bf_candidates.fv_candidates);
+
+        V1 = V0 + 0.5 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+    }
+}
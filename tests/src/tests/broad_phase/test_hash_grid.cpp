@@ -0,0 +1,92 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+
+using namespace ipc;
+
+TEST_CASE("Radix sort HashGrid", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+    V1 = V0 + 0.5 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+
+    const bool use_radix_sort = GENERATE(false, true);
+    const double inflation_radius = 1e-2;
+
+    HashGrid hash_grid(use_radix_sort);
+    BruteForce bf;
+    hash_grid.build(V0, V1, E, F, inflation_radius);
+    bf.build(V0, V1, E, F, inflation_radius);
+
+    std::vector<VertexVertexCandidate> vv, bf_vv;
+    hash_grid.detect_vertex_vertex_candidates(vv);
+    bf.detect_vertex_vertex_candidates(bf_vv);
+    tests::check_candidates(vv, bf_vv);
+
+    std::vector<EdgeVertexCandidate> ev, bf_ev;
+    hash_grid.detect_edge_vertex_candidates(ev);
+    bf.detect_edge_vertex_candidates(bf_ev);
+    tests::check_candidates(ev, bf_ev);
+
+    std::vector<EdgeEdgeCandidate> ee, bf_ee;
+    hash_grid.detect_edge_edge_candidates(ee);
+    bf.detect_edge_edge_candidates(bf_ee);
+    tests::check_candidates(ee, bf_ee);
+
+    std::vector<FaceVertexCandidate> fv, bf_fv;
+    hash_grid.detect_face_vertex_candidates(fv);
+    bf.detect_face_vertex_candidates(bf_fv);
+    tests::check_candidates(fv, bf_fv);
+}
+
+TEST_CASE("Update HashGrid", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    // Small motions reuse the grid and large ones leave its domain.
+    const double displacement = GENERATE(1e-3, 0.1, 2.0);
+    const double inflation_radius = 1e-2;
+    // Update explicitly or through build (e.g., from Candidates::build).
+    const bool update_in_build = GENERATE(false, true);
+
+    HashGrid hash_grid;
+    hash_grid.enable_update = update_in_build;
+    hash_grid.profile = std::make_shared<BroadPhaseProfile>();
+    hash_grid.build(V0, E, F, inflation_radius);
+
+    Eigen::MatrixXd V = V0;
+    for (int i = 0; i < 3; i++) {
+        V += displacement * Eigen::MatrixXd::Random(V.rows(), V.cols());
+        hash_grid.profile->reset();
+        if (update_in_build) {
+            hash_grid.build(V, E, F, inflation_radius);
+        } else {
+            hash_grid.update(V, E, F, inflation_radius);
+        }
+
+        // Updating the boxes is profiled like building them.
+        CHECK(
+            hash_grid.profile->num_boxes == V.rows() + E.rows() + F.rows());
+        CHECK(hash_grid.profile->memory_usage > 0);
+
+        BruteForce bf;
+        bf.build(V, E, F, inflation_radius);
+
+        std::vector<EdgeEdgeCandidate> ee, bf_ee;
+        hash_grid.detect_edge_edge_candidates(ee);
+        bf.detect_edge_edge_candidates(bf_ee);
+        tests::check_candidates(ee, bf_ee);
+
+        std::vector<FaceVertexCandidate> fv, bf_fv;
+        hash_grid.detect_face_vertex_candidates(fv);
+        bf.detect_face_vertex_candidates(bf_fv);
+        tests::check_candidates(fv, bf_fv);
+    }
+}
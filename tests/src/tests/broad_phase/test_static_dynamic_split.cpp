@@ -0,0 +1,158 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/static_dynamic_split.hpp>
+#include <ipc/candidates/candidates.hpp>
+
+#include <algorithm>
+
+using namespace ipc;
+
+namespace {
+template <typename Candidate, typename IsStaticPair>
+void check_split_candidates(
+    const BroadPhase& broad_phase,
+    const BroadPhase& brute_force,
+    void (BroadPhase::*detect)(std::vector<Candidate>&) const,
+    const IsStaticPair& is_static_pair)
+{
+    std::vector<Candidate> candidates, expected_candidates;
+    (broad_phase.*detect)(candidates);
+    (brute_force.*detect)(expected_candidates);
+
+    // Static-static pairs are never checked
+    expected_candidates.erase(
+        std::remove_if(
+            expected_candidates.begin(), expected_candidates.end(),
+            is_static_pair),
+        expected_candidates.end());
+
+    tests::check_candidates(candidates, expected_candidates);
+}
+} // namespace
+
+TEST_CASE("Static dynamic split", "[broad_phase][static_dynamic_split]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(tests::load_mesh("cube.obj", V_cube, E_cube, F_cube));
+    const int n = V_cube.rows();
+
+    // A static cube and an overlapping dynamic cube
+    Eigen::MatrixXd V0(2 * n, 3);
+    V0 << V_cube, V_cube.rowwise() + Eigen::RowVector3d(0.5, 0.5, 0.5);
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    std::vector<bool> is_vertex_static(2 * n, false);
+    std::fill_n(is_vertex_static.begin(), n, true);
+
+    const auto is_static = [&](const long vi) { return is_vertex_static[vi]; };
+    const auto is_edge_static = [&](const long ei) {
+        return is_static(E(ei, 0)) && is_static(E(ei, 1));
+    };
+    const auto is_face_static = [&](const long fi) {
+        return is_static(F(fi, 0)) && is_static(F(fi, 1))
+            && is_static(F(fi, 2));
+    };
+
+    StaticDynamicSplit split(BroadPhase::make_broad_phase(method));
+    split.is_vertex_static = is_vertex_static;
+    BruteForce bf;
+
+    const double inflation_radius = 1e-2;
+    for (int i = 0; i < 3; i++) {
+        Eigen::MatrixXd V1 = V0;
+        V1.bottomRows(n) += 0.5 * Eigen::MatrixXd::Random(n, 3);
+
+        split.build(V0, V1, E, F, inflation_radius);
+        bf.build(V0, V1, E, F, inflation_radius);
+        CHECK(split.is_static_built());
+        // The static BVHs are only built by the first build.
+        CHECK(split.was_static_rebuilt() == (i == 0));
+
+        check_split_candidates<VertexVertexCandidate>(
+            split, bf, &BroadPhase::detect_vertex_vertex_candidates,
+            [&](const VertexVertexCandidate& c) {
+                return is_static(c.vertex0_id) && is_static(c.vertex1_id);
+            });
+        check_split_candidates<EdgeVertexCandidate>(
+            split, bf, &BroadPhase::detect_edge_vertex_candidates,
+            [&](const EdgeVertexCandidate& c) {
+                return is_edge_static(c.edge_id) && is_static(c.vertex_id);
+            });
+        check_split_candidates<EdgeEdgeCandidate>(
+            split, bf, &BroadPhase::detect_edge_edge_candidates,
+            [&](const EdgeEdgeCandidate& c) {
+                return is_edge_static(c.edge0_id) && is_edge_static(c.edge1_id);
+            });
+        check_split_candidates<FaceVertexCandidate>(
+            split, bf, &BroadPhase::detect_face_vertex_candidates,
+            [&](const FaceVertexCandidate& c) {
+                return is_face_static(c.face_id) && is_static(c.vertex_id);
+            });
+        check_split_candidates<EdgeFaceCandidate>(
+            split, bf, &BroadPhase::detect_edge_face_candidates,
+            [&](const EdgeFaceCandidate& c) {
+                return is_edge_static(c.edge_id) && is_face_static(c.face_id);
+            });
+
+        V0 = V1;
+    }
+
+    split.clear();
+    CHECK(!split.is_static_built());
+}
+
+TEST_CASE(
+    "Static dynamic split through candidates",
+    "[broad_phase][static_dynamic_split][candidates]")
+{
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(tests::load_mesh("cube.obj", V_cube, E_cube, F_cube));
+    const int n = V_cube.rows();
+
+    Eigen::MatrixXd V0(2 * n, 3);
+    V0 << V_cube, V_cube.rowwise() + Eigen::RowVector3d(0.5, 0.5, 0.5);
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    CollisionMesh mesh(V0, E, F);
+    mesh.is_vertex_static.assign(2 * n, false);
+    std::fill_n(mesh.is_vertex_static.begin(), n, true);
+
+    const auto is_edge_static = [&](const long ei) {
+        return mesh.is_vertex_static[E(ei, 0)]
+            && mesh.is_vertex_static[E(ei, 1)];
+    };
+
+    StaticDynamicSplit split;
+    const double inflation_radius = 1e-2;
+    for (int i = 0; i < 3; i++) {
+        Eigen::MatrixXd V1 = V0;
+        V1.bottomRows(n) += 0.1 * Eigen::MatrixXd::Random(n, 3);
+
+        Candidates candidates;
+        candidates.build(mesh, V0, V1, inflation_radius, split);
+
+        // The static vertices are read from the mesh and the static BVHs
+        // are reused by the later builds.
+        CHECK(split.is_vertex_static == mesh.is_vertex_static);
+        CHECK(split.was_static_rebuilt() == (i == 0));
+
+        for (const EdgeEdgeCandidate& c : candidates.ee_candidates) {
+            CHECK(!(is_edge_static(c.edge0_id) && is_edge_static(c.edge1_id)));
+        }
+
+        V0 = V1;
+    }
+}
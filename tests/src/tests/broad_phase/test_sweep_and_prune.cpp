@@ -0,0 +1,122 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/sweep_and_prune.hpp>
+
+#include <algorithm>
+
+using namespace ipc;
+
+namespace {
+template <typename Candidate>
+void check_delta(
+    std::vector<Candidate> previous,
+    const CandidatesDelta<Candidate>& delta,
+    const std::vector<Candidate>& current)
+{
+    std::sort(previous.begin(), previous.end());
+    for (const Candidate& candidate : delta.removed) {
+        const auto it =
+            std::lower_bound(previous.begin(), previous.end(), candidate);
+        REQUIRE(it != previous.end());
+        CHECK(*it == candidate);
+        previous.erase(it);
+    }
+    previous.insert(previous.end(), delta.added.begin(), delta.added.end());
+    tests::check_candidates(previous, current);
+}
+} // namespace
+
+TEST_CASE("Coherent sweep and prune", "[broad_phase][sweep_and_prune]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    // Small motions are updated incrementally and large ones are rebuilt.
+    const double displacement = GENERATE(1e-3, 0.1, 2.0);
+    const double inflation_radius = 1e-2;
+
+    CoherentSweepAndPrune sap;
+    sap.build(V0, E, F, inflation_radius);
+    CHECK(!sap.was_incremental());
+
+    std::vector<EdgeEdgeCandidate> ee;
+    std::vector<FaceVertexCandidate> fv;
+    sap.detect_edge_edge_candidates(ee);
+    sap.detect_face_vertex_candidates(fv);
+
+    Eigen::MatrixXd V = V0;
+    for (int i = 0; i < 3; i++) {
+        V += displacement * Eigen::MatrixXd::Random(V.rows(), V.cols());
+        sap.build(V, E, F, inflation_radius);
+        if (displacement < 1e-2) {
+            CHECK(sap.was_incremental());
+        }
+
+        BruteForce bf;
+        bf.build(V, E, F, inflation_radius);
+
+        std::vector<EdgeEdgeCandidate> new_ee, bf_ee;
+        sap.detect_edge_edge_candidates(new_ee);
+        bf.detect_edge_edge_candidates(bf_ee);
+        tests::check_candidates(new_ee, bf_ee);
+        check_delta(ee, sap.edge_edge_delta(), new_ee);
+        ee = new_ee;
+
+        std::vector<FaceVertexCandidate> new_fv, bf_fv;
+        sap.detect_face_vertex_candidates(new_fv);
+        bf.detect_face_vertex_candidates(bf_fv);
+        tests::check_candidates(new_fv, bf_fv);
+        check_delta(fv, sap.face_vertex_delta(), new_fv);
+        fv = new_fv;
+    }
+}
+
+TEST_CASE("Coherent sweep and prune 2D", "[broad_phase][sweep_and_prune]")
+{
+    // A zig-zag polyline folded back onto itself.
+    const int n = 20;
+    Eigen::MatrixXd V0(n, 2);
+    Eigen::MatrixXi E(n - 1, 2);
+    for (int i = 0; i < n; i++) {
+        V0.row(i) << 0.1 * (i % 10), 0.05 * (i / 10) + 0.02 * (i % 2);
+    }
+    for (int i = 0; i < n - 1; i++) {
+        E.row(i) << i, i + 1;
+    }
+    const Eigen::MatrixXi F;
+    const double inflation_radius = 1e-2;
+
+    CoherentSweepAndPrune sap;
+    sap.build(V0, E, F, inflation_radius);
+
+    Eigen::MatrixXd V = V0;
+    for (int i = 0; i < 3; i++) {
+        V += 1e-3 * Eigen::MatrixXd::Random(V.rows(), V.cols());
+        sap.build(V, E, F, inflation_radius);
+        CHECK(sap.was_incremental());
+
+        BruteForce bf;
+        bf.build(V, E, F, inflation_radius);
+
+        std::vector<EdgeVertexCandidate> ev, bf_ev;
+        sap.detect_edge_vertex_candidates(ev);
+        bf.detect_edge_vertex_candidates(bf_ev);
+        tests::check_candidates(ev, bf_ev);
+
+        std::vector<VertexVertexCandidate> vv, bf_vv;
+        sap.detect_vertex_vertex_candidates(vv);
+        bf.detect_vertex_vertex_candidates(bf_vv);
+        tests::check_candidates(vv, bf_vv);
+
+        // Edge-edge pairs are not tracked in 2D but are still found.
+        std::vector<EdgeEdgeCandidate> ee, bf_ee;
+        sap.detect_edge_edge_candidates(ee);
+        bf.detect_edge_edge_candidates(bf_ee);
+        tests::check_candidates(ee, bf_ee);
+    }
+}
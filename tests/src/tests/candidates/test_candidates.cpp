@@ -1,7 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <tests/utils.hpp>
 
 #include <ipc/candidates/candidates.hpp>
 
+#include <limits>
+
 using namespace ipc;
 
 TEST_CASE("Candidates", "[candidates]")
@@ -72,6 +77,45 @@ TEST_CASE("Candidates", "[candidates]")
     }
 }
 
+TEST_CASE("Filtered candidates", "[candidates][broad_phase]")
+{
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V, E, F));
+    const CollisionMesh mesh(V, E, F);
+
+    const double inflation_radius = 1e-2;
+    const auto filter = [&](const CollisionStencil& candidate) {
+        return candidate.compute_distance(
+                   candidate.dof(V, mesh.edges(), mesh.faces()))
+            < inflation_radius * inflation_radius;
+    };
+
+    Candidates expected;
+    expected.build(mesh, V, inflation_radius, method);
+    const auto remove_rejected = [&](auto& candidates) {
+        candidates.erase(
+            std::remove_if(
+                candidates.begin(), candidates.end(),
+                [&](const auto& c) { return !filter(c); }),
+            candidates.end());
+    };
+    remove_rejected(expected.ev_candidates);
+    remove_rejected(expected.ee_candidates);
+    remove_rejected(expected.fv_candidates);
+
+    Candidates candidates;
+    candidates.build(mesh, V, inflation_radius, method, filter);
+
+    CHECK(candidates.vv_candidates.empty());
+    tests::check_candidates(candidates.ev_candidates, expected.ev_candidates);
+    tests::check_candidates(candidates.ee_candidates, expected.ee_candidates);
+    tests::check_candidates(candidates.fv_candidates, expected.fv_candidates);
+}
+
 TEST_CASE("Vertex-Vertex Candidate", "[candidates][vertex-vertex]")
 {
     CHECK(VertexVertexCandidate(0, 1) == VertexVertexCandidate(0, 1));
@@ -137,3 +181,47 @@ TEST_CASE("Face-Face Candidate", "[candidates][face-face]")
     CHECK(FaceFaceCandidate(0, 1) < FaceFaceCandidate(2, 0));
     CHECK(!(FaceFaceCandidate(1, 1) < FaceFaceCandidate(0, 2)));
 }
+
+TEST_CASE("TOI lower bound", "[candidates][ccd]")
+{
+    const FaceVertexCandidate candidate(0, 1);
+
+    VectorMax12d vertices_t0(12), vertices_t1(12);
+    vertices_t0 << 0, 0, 1, -1, -1, 0, 1, -1, 0, 0, 1, 0;
+    vertices_t1 = vertices_t0;
+
+    SECTION("Static")
+    {
+        CHECK(
+            candidate.toi_lower_bound(vertices_t0, vertices_t1)
+            == std::numeric_limits<double>::infinity());
+    }
+
+    SECTION("Translating")
+    {
+        vertices_t1.array() += 10;
+        CHECK(
+            candidate.toi_lower_bound(vertices_t0, vertices_t1)
+            == std::numeric_limits<double>::infinity());
+    }
+
+    SECTION("Already within min. distance")
+    {
+        vertices_t1(2) = -1;
+        CHECK(candidate.toi_lower_bound(vertices_t0, vertices_t1, 1.5) == 0);
+    }
+
+    SECTION("Colliding")
+    {
+        const double min_distance = GENERATE(0.0, 0.1);
+        vertices_t1(2) = -1;
+
+        const double toi_lower_bound =
+            candidate.toi_lower_bound(vertices_t0, vertices_t1, min_distance);
+        CHECK(toi_lower_bound > 0);
+
+        double toi;
+        REQUIRE(candidate.ccd(vertices_t0, vertices_t1, toi, min_distance));
+        CHECK(toi_lower_bound <= toi);
+    }
+}
@@ -182,6 +182,57 @@ TEST_CASE("Codim. edge-vertex collisions", "[collisions][codim]")
     }
 }
 
+TEST_CASE("Codim. candidates with can_collide", "[collisions][codim]")
+{
+    Eigen::MatrixXd vertices(8, 3);
+    vertices << 0, 0, 0, //
+        1, 0, 0,         //
+        0, 0, -1,        //
+        -1, 0, 0,        //
+        0, 0, 1,         //
+        0, 1, 0,         //
+        0, 2, 0,         //
+        0, 3, 0;
+    Eigen::MatrixXi edges(4, 2);
+    edges << 0, 1, //
+        0, 2,      //
+        0, 3,      //
+        0, 4;
+
+    CollisionMesh mesh(vertices, edges, Eigen::MatrixXi());
+    REQUIRE(mesh.num_codim_vertices() == 3);
+
+    // Exclude the codim. vertices 5 and 7 (local ids 0 and 2) from colliding.
+    mesh.can_collide = [](size_t vi, size_t vj) {
+        return std::minmax(vi, vj) != std::minmax<size_t>(5, 7);
+    };
+
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    Eigen::MatrixXd V1 = vertices;
+    V1.bottomRows(3).col(1).array() -= 4; // Translate the codim vertices
+
+    Candidates candidates;
+    SECTION("Method")
+    {
+        candidates.build(mesh, vertices, V1, /*inflation_radius=*/1e-3, method);
+    }
+    SECTION("Persistent broad phase")
+    {
+        const std::shared_ptr<BroadPhase> broad_phase =
+            BroadPhase::make_broad_phase(method);
+        candidates.build(
+            mesh, vertices, V1, /*inflation_radius=*/1e-3, *broad_phase);
+    }
+
+    CHECK(candidates.ev_candidates.size() == 12);
+    REQUIRE(candidates.vv_candidates.size() == 2);
+    for (const auto& [vi, vj] : candidates.vv_candidates) {
+        CHECK(std::minmax(vi, vj) != std::minmax<index_t>(5, 7));
+    }
+}
+
 TEST_CASE("Vertex-Vertex Collision", "[collision][vertex-vertex]")
 {
     CHECK(VertexVertexCollision(0, 1) == VertexVertexCollision(0, 1));
@@ -248,7 +299,7 @@ TEST_CASE("Plane-Vertex Collision", "[collision][plane-vertex]")
     CHECK(c.num_vertices() == 1);
     CHECK(
         c.vertex_ids(edges, faces)
-        == std::array<long, 4> { { 0, -1, -1, -1 } });
+        == std::array<index_t, 4> { { 0, -1, -1, -1 } });
     CHECK(c.plane_origin == o);
     CHECK(c.plane_normal == n);
     CHECK(c.vertex_id == 0);
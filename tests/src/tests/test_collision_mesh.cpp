@@ -1,4 +1,7 @@
+#include <tests/utils.hpp>
+
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include <ipc/collision_mesh.hpp>
 
@@ -118,4 +121,69 @@ TEST_CASE("Codim points collision mesh", "[collision_mesh]")
     Eigen::VectorXi expected_codim_vertices(4);
     expected_codim_vertices << 0, 1, 2, 3;
     CHECK(mesh.codim_vertices() == expected_codim_vertices);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Reordered collision mesh", "[collision_mesh][reorder]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V, E, F));
+
+    const CollisionMesh mesh(V, E, F);
+    const CollisionMesh reordered(
+        V, E, F, Eigen::SparseMatrix<double>(), /*reorder=*/true);
+
+    REQUIRE(reordered.num_vertices() == mesh.num_vertices());
+    REQUIRE(reordered.num_edges() == mesh.num_edges());
+    REQUIRE(reordered.num_faces() == mesh.num_faces());
+
+    // The unordered mesh maps everything to itself
+    CHECK(mesh.to_input_edge_id(1) == 1);
+    CHECK(mesh.to_input_face_id(1) == 1);
+
+    for (size_t vi = 0; vi < reordered.num_vertices(); vi++) {
+        const size_t full_vi = reordered.to_full_vertex_id(vi);
+        CHECK(reordered.rest_positions().row(vi) == V.row(full_vi));
+        CHECK(
+            reordered.vertex_area(vi)
+            == Catch::Approx(mesh.vertex_area(full_vi)));
+    }
+
+    for (size_t ei = 0; ei < reordered.num_edges(); ei++) {
+        const size_t input_ei = reordered.to_input_edge_id(ei);
+        for (int j = 0; j < 2; j++) {
+            CHECK(
+                reordered.to_full_vertex_id(reordered.edges()(ei, j))
+                == E(input_ei, j));
+        }
+        CHECK(
+            reordered.edge_area(ei) == Catch::Approx(mesh.edge_area(input_ei)));
+    }
+
+    for (size_t fi = 0; fi < reordered.num_faces(); fi++) {
+        const size_t input_fi = reordered.to_input_face_id(fi);
+        for (int j = 0; j < 3; j++) {
+            CHECK(
+                reordered.to_full_vertex_id(reordered.faces()(fi, j))
+                == F(input_fi, j));
+        }
+    }
+
+    // Positions and gradients are mapped through the permutation
+    const Eigen::MatrixXd U = Eigen::MatrixXd::Random(V.rows(), V.cols());
+    const Eigen::MatrixXd Vc = reordered.displace_vertices(U);
+    Eigen::VectorXd g(reordered.ndof());
+    for (size_t vi = 0; vi < reordered.num_vertices(); vi++) {
+        const size_t full_vi = reordered.to_full_vertex_id(vi);
+        CHECK(Vc.row(vi) == V.row(full_vi) + U.row(full_vi));
+        g.segment<3>(3 * vi) = U.row(full_vi);
+    }
+    CHECK(reordered.to_full_dof(g) == U.reshaped<Eigen::RowMajor>());
+
+    // The full mesh helper forwards the reorder option
+    const CollisionMesh built =
+        CollisionMesh::build_from_full_mesh(V, E, F, /*reorder=*/true);
+    CHECK(built.rest_positions() == reordered.rest_positions());
+    CHECK(built.edges() == reordered.edges());
+    CHECK(built.faces() == reordered.faces());
+}
@@ -4,9 +4,12 @@
 #include <catch2/generators/catch_generators_adapters.hpp>
 
 #include <ipc/ipc.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
 
 #include <igl/edges.h>
 
+#include <atomic>
+
 using namespace ipc;
 
 Eigen::MatrixXi remove_faces_with_degenerate_edges(
@@ -96,3 +99,108 @@ TEST_CASE("Has intersections", "[intersection]")
     CAPTURE(broad_phase_method);
     CHECK(has_intersections(CollisionMesh(V, E, F), V, broad_phase_method));
 }
+
+TEST_CASE("Has intersections of moved primitives", "[intersection]")
+{
+    const BroadPhaseMethod broad_phase_method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(broad_phase_method);
+
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(tests::load_mesh("cube.obj", V_cube, E_cube, F_cube));
+    const int n = V_cube.rows();
+
+    // A cube at rest and a cube moving towards it
+    Eigen::MatrixXd V_verified(2 * n, 3);
+    V_verified << V_cube, V_cube.rowwise() + Eigen::RowVector3d(3, 0, 0);
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    const CollisionMesh mesh(V_verified, E, F);
+    REQUIRE(!has_intersections(mesh, V_verified, broad_phase_method));
+
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(broad_phase_method);
+
+    // Nothing moved
+    CHECK(!has_intersections(mesh, V_verified, V_verified, 0, *broad_phase));
+
+    // Still separated
+    Eigen::MatrixXd V = V_verified;
+    V.bottomRows(n).col(0).array() -= 1;
+    CHECK(!has_intersections(mesh, V_verified, V, 1e-8, *broad_phase));
+
+    // Overlapping
+    V.bottomRows(n).col(0).array() -= 1.5;
+    CHECK(has_intersections(mesh, V, broad_phase_method));
+    CHECK(has_intersections(mesh, V_verified, V, 1e-8, *broad_phase));
+
+    // The motion is below the tolerance so nothing is checked
+    CHECK(!has_intersections(mesh, V_verified, V, 10, *broad_phase));
+
+    // The caller's filters are restored
+    bool (*const can_collide)(size_t, size_t) = [](size_t, size_t) {
+        return true;
+    };
+    broad_phase->can_vertices_collide = can_collide;
+    const Eigen::VectorXi vertex_groups = Eigen::VectorXi::Zero(2 * n);
+    broad_phase->collision_groups = CollisionGroups(vertex_groups, { 1 });
+    CHECK(has_intersections(mesh, V_verified, V, 1e-8, *broad_phase));
+    const auto* filter =
+        broad_phase->can_vertices_collide.target<bool (*)(size_t, size_t)>();
+    REQUIRE(filter != nullptr);
+    CHECK(*filter == can_collide);
+    CHECK(broad_phase->collision_groups.vertex_groups() == vertex_groups);
+}
+
+namespace {
+/// @brief Hash grid that counts the edge-face candidates it streams.
+class CountingHashGrid : public HashGrid {
+public:
+    void visit_edge_face_candidates(
+        const CandidateVisitor<EdgeFaceCandidate>& visitor) const override
+    {
+        HashGrid::visit_edge_face_candidates(
+            [&](const EdgeFaceCandidate& candidate) {
+                ++num_visited;
+                visitor(candidate);
+            });
+    }
+
+    mutable std::atomic<size_t> num_visited { 0 };
+};
+} // namespace
+
+TEST_CASE("Has intersections exits early", "[intersection]")
+{
+    Eigen::MatrixXd V_bunny;
+    Eigen::MatrixXi E_bunny, F_bunny;
+    REQUIRE(tests::load_mesh("bunny.obj", V_bunny, E_bunny, F_bunny));
+    const int n = V_bunny.rows();
+
+    // Two copies of the bunny moved from far apart to slightly overlapping,
+    // so most edge-face candidates intersect.
+    const Eigen::RowVector3d offset = 1e-2
+        * (V_bunny.colwise().maxCoeff() - V_bunny.colwise().minCoeff());
+    const Eigen::RowVector3d far =
+        10 * offset.norm() * Eigen::RowVector3d::UnitX();
+    Eigen::MatrixXd V_verified(2 * n, 3), V(2 * n, 3);
+    V_verified << V_bunny.rowwise() - far, V_bunny.rowwise() + far;
+    V << V_bunny, V_bunny.rowwise() + offset;
+    Eigen::MatrixXi E(2 * E_bunny.rows(), 2), F(2 * F_bunny.rows(), 3);
+    E << E_bunny, E_bunny.array() + n;
+    F << F_bunny, F_bunny.array() + n;
+
+    const CollisionMesh mesh(V_verified, E, F);
+
+    CountingHashGrid hash_grid;
+    CHECK(has_intersections(mesh, V_verified, V, 0, hash_grid));
+
+    // The traversal was cancelled before streaming every candidate.
+    const size_t num_visited = hash_grid.num_visited;
+    std::vector<EdgeFaceCandidate> candidates;
+    hash_grid.detect_edge_face_candidates(candidates);
+    CAPTURE(num_visited, candidates.size());
+    CHECK(num_visited < candidates.size());
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
 
 #include <ipc/collisions/collisions.hpp>
@@ -8,7 +9,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #ifdef IPC_TOOLKIT_WITH_CUDA
 #define NUM_BROAD_PHASE_METHODS static_cast<int>(BroadPhaseMethod::NUM_METHODS)
@@ -32,6 +35,18 @@ bool load_mesh(
 
 // ============================================================================
 
+/// @brief Check that two lists of candidates are equal up to their order.
+template <typename Candidate>
+void check_candidates(
+    std::vector<Candidate> candidates, std::vector<Candidate> expected)
+{
+    std::sort(candidates.begin(), candidates.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(candidates == expected);
+}
+
+// ============================================================================
+
 void mmcvids_to_collisions(
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
@@ -5,13 +5,19 @@
 #include <ipc/candidates/edge_edge.hpp>
 #include <ipc/candidates/face_vertex.hpp>
 #include <ipc/candidates/edge_face.hpp>
+#include <ipc/candidates/face_face.hpp>
 #include <ipc/utils/logger.hpp>
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/save_obj.hpp>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <sstream>
+#include <type_traits>
 
 TEST_CASE("Logger", "[utils][logger]")
 {
@@ -114,4 +120,87 @@ TEST_CASE("Save OBJ of candidates", "[utils][save_obj]")
             ss.str()
             == "o EF\nv 1 0 0\nv 0 1 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\nl 1 2\nf 3 4 5\n");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Merge thread-local vectors", "[utils][merge_thread_local]")
+{
+    const int n = 100'000;
+
+    SECTION("Candidates")
+    {
+        // Candidates take the parallel copy.
+        STATIC_REQUIRE(
+            std::is_default_constructible_v<ipc::VertexVertexCandidate>);
+        STATIC_REQUIRE(
+            std::is_default_constructible_v<ipc::EdgeVertexCandidate>);
+        STATIC_REQUIRE(std::is_default_constructible_v<ipc::EdgeEdgeCandidate>);
+        STATIC_REQUIRE(
+            std::is_default_constructible_v<ipc::FaceVertexCandidate>);
+        STATIC_REQUIRE(std::is_default_constructible_v<ipc::EdgeFaceCandidate>);
+        STATIC_REQUIRE(std::is_default_constructible_v<ipc::FaceFaceCandidate>);
+
+        tbb::enumerable_thread_specific<std::vector<ipc::EdgeEdgeCandidate>>
+            storage;
+        tbb::parallel_for(0, n, [&](int i) {
+            storage.local().emplace_back(i, i + 1);
+        });
+
+        std::vector<ipc::EdgeEdgeCandidate> merged;
+        merged.emplace_back(-1, 0);
+        ipc::merge_thread_local_vectors(storage, merged);
+
+        REQUIRE(merged.size() == n + 1);
+        CHECK(merged[0] == ipc::EdgeEdgeCandidate(-1, 0));
+        std::sort(merged.begin(), merged.end());
+        bool is_complete = true;
+        for (int i = 0; i <= n; i++) {
+            is_complete &= merged[i] == ipc::EdgeEdgeCandidate(i - 1, i);
+        }
+        CHECK(is_complete);
+    }
+
+    SECTION("Not default constructible")
+    {
+        struct Item {
+            explicit Item(int _value) : value(_value) { }
+            int value;
+        };
+        STATIC_REQUIRE(!std::is_default_constructible_v<Item>);
+
+        tbb::enumerable_thread_specific<std::vector<Item>> storage;
+        tbb::parallel_for(
+            0, n, [&](int i) { storage.local().emplace_back(i); });
+
+        std::vector<Item> merged;
+        merged.emplace_back(-1);
+        ipc::merge_thread_local_vectors(storage, merged);
+
+        REQUIRE(merged.size() == n + 1);
+        std::sort(
+            merged.begin(), merged.end(),
+            [](const Item& a, const Item& b) { return a.value < b.value; });
+        bool is_complete = true;
+        for (int i = 0; i <= n; i++) {
+            is_complete &= merged[i].value == i - 1;
+        }
+        CHECK(is_complete);
+    }
+
+    SECTION("Default constructible")
+    {
+        tbb::enumerable_thread_specific<std::vector<int>> storage;
+        tbb::parallel_for(0, n, [&](int i) { storage.local().push_back(i); });
+
+        std::vector<int> merged = { -1 };
+        ipc::merge_thread_local_vectors(storage, merged);
+
+        REQUIRE(merged.size() == n + 1);
+        CHECK(merged[0] == -1);
+        std::sort(merged.begin(), merged.end());
+        bool is_complete = true;
+        for (int i = 0; i <= n; i++) {
+            is_complete &= merged[i] == i - 1;
+        }
+        CHECK(is_complete);
+    }
+}